@@ -0,0 +1,408 @@
+#pragma once
+
+#include <tbb\spin_mutex.h>
+#include <tbb\task_arena.h>
+#include <tbb\task_group.h>
+
+#include "GameBoard.hpp"
+#include "HeuristicScorer.hpp"
+#include "MoveOrdering.hpp"
+#include "SearchControl.hpp"
+#include "SearchResult.hpp"
+#include "SearchStats.hpp"
+#include "ThreatFilter.hpp"
+#include "TranspositionTable.hpp"
+#include "WindowEvaluator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <memory>
+
+namespace controller {
+
+	//Alpha-beta search for a board of any size. Searches are made by create, which picks a search compiled for the size
+	//of the board when there is one and otherwise falls back to the search for boards sized at run time.
+	class AlphaBetaSearch {
+
+	public:
+
+		virtual ~AlphaBetaSearch() {
+		}
+
+		//Switch stages of the move ordering on or off for the searches that follow
+		virtual void setMoveOrderingOptions(MoveOrderingOptions moveOrderingOptions) = 0;
+
+		//Let the searches that follow be cancelled and polled through the control. Null searches without one.
+		virtual void setSearchControl(SearchControl* searchControl) = 0;
+
+		//Find the best move for the player to move looking the given number of moves ahead
+		virtual SearchResult search(const model::GameBoard& gameBoard, int depth, bool isUserCoin) = 0;
+
+		//Find the best move for the player to move within the time budget
+		virtual SearchResult searchWithTimeBudget(const model::GameBoard& gameBoard, std::chrono::steady_clock::duration moveTimeBudget, bool isUserCoin) = 0;
+
+		//Search on the board type that suits the board, see model::createForBoardType
+		static std::unique_ptr<AlphaBetaSearch> create(int numberOfRows, int numberOfColumns, int winLength, const HeuristicScorer& heuristicScorer, TranspositionTable& transpositionTable);
+
+	};
+
+	//Negamax search with alpha-beta pruning and principal variation search. The score of a move is its heuristic score
+	//less the best score the opponent can get in reply, the same as in the minimax search. Both searches also settle
+	//positions and leave moves out by the threat filter in the same way, so they agree on the score of a position. At
+	//every node the eldest child is searched on its own first. Its score then bounds the younger siblings, which are
+	//searched in parallel in a task group (young brothers wait), the root included. The tasks share the siblings out
+	//between them as they go. When a sibling scores at or above beta the rest of the group is cancelled.
+	//The search can also deepen one move at a time until a time budget runs out and then play the best move of the
+	//last depth that was searched completely.
+	//The search runs on its own copy of the board in the board type it is compiled for. Boards, window counts and move
+	//lists are fixed size values kept on the stack of each node, so the search takes no scratch memory from the heap.
+	template <typename GameBoardType>
+	class BasicAlphaBetaSearch : public AlphaBetaSearch {
+
+	private:
+
+		typedef BasicWindowEvaluator<GameBoardType> WindowEvaluatorType;
+
+		//Constants
+		const static int MINIMUM_DEPTH_FOR_PARALLEL_SIBLINGS = 3;
+		const static int NODES_BETWEEN_CLOCK_CHECKS = 256;
+
+		//Members
+		const HeuristicScorer& heuristicScorer;
+		TranspositionTable& transpositionTable;
+		MoveOrdering moveOrdering;
+		SearchControl* searchControl;
+		SearchStatsCounters searchStatsCounters;
+		int rootDepth;
+		std::atomic<std::uint64_t> nodeCount;
+		std::atomic<bool> searchStopped;
+		bool hasDeadline;
+		std::chrono::steady_clock::time_point deadline;
+
+		//Check if the result of the current search is going to be thrown away, either because the deadline has passed,
+		//the search was cancelled, or a sibling of an ancestor has cut this subtree off
+		bool isSearchAborted() const {
+
+			return isSearchStopped() || tbb::is_current_task_group_canceling();
+
+		}
+
+		bool isSearchStopped() const {
+
+			return this->searchStopped.load(std::memory_order_relaxed) || (this->searchControl != nullptr && this->searchControl->isCancelled());
+
+		}
+
+		//Read the clock every so many nodes searched by a thread and stop the search once the deadline has passed
+		void checkDeadline() {
+
+			static thread_local int nodesSinceClockCheck = 0;
+			if (++nodesSinceClockCheck < NODES_BETWEEN_CLOCK_CHECKS) {
+				return;
+			}
+
+			nodesSinceClockCheck = 0;
+			if (std::chrono::steady_clock::now() >= this->deadline) {
+				this->searchStopped.store(true, std::memory_order_relaxed);
+			}
+
+		}
+
+		//Score a move by dropping the coin and searching the opponent replies. Search windows are kept as long long
+		//because moving a window from one side to the other can take it outside the range of int.
+		int searchMove(GameBoardType& gameBoard, WindowEvaluatorType& windowEvaluator, int columnPlayed, int depth, long long alpha, long long beta, bool isUserCoin, std::uint64_t& nodes) {
+
+			++nodes;
+			this->searchStatsCounters.countNode(this->rootDepth - depth + 1);
+
+			if (this->hasDeadline) {
+				checkDeadline();
+			}
+
+			int moveScore = windowEvaluator.getMoveHueristicScore(gameBoard, columnPlayed, isUserCoin);
+			this->searchStatsCounters.countEvaluation();
+			if (moveScore == HeuristicScorer::WINNING_SCORE || depth == 1) {
+				this->searchStatsCounters.countLeaf();
+				return moveScore;
+			}
+
+			int bestOpponentMove;
+			windowEvaluator.dropCoin(gameBoard, columnPlayed, isUserCoin);
+			int opponentScore = negamax(gameBoard, windowEvaluator, depth - 1, moveScore - beta, moveScore - alpha, isUserCoin ? false : true, nodes, bestOpponentMove, -1);
+			windowEvaluator.undoCoin(gameBoard, columnPlayed);
+
+			return HeuristicScorer::subtractHeuristicScores(moveScore, opponentScore);
+		}
+
+		//Search the younger siblings in parallel once the eldest has been searched. No more tasks are started than there
+		//are threads to run them, and each task keeps taking the next sibling nobody has started until none are left, so
+		//a thread that finishes a small subtree moves on to another sibling instead of waiting on the thread with the
+		//largest one. This matters most on wide boards, where a node can have twenty siblings of very different sizes.
+		//Each task works on its own copy of the board, made once, with a null window around the best score found so far
+		//and searches again with the full window only if the move turns out to be better.
+		void searchYoungerBrothers(const GameBoardType& gameBoard, const WindowEvaluatorType& windowEvaluator, const int* moves, int numberOfMoves, int depth, long long& alpha, long long beta, bool isUserCoin, int& bestScore, int& bestMove) {
+
+			std::atomic<long long> sharedAlpha(alpha);
+			std::atomic<int> nextMove(1);
+			tbb::spin_mutex bestScoreMutex;
+			tbb::task_group youngerBrothers;
+
+			int numberOfTasks = std::min(numberOfMoves - 1, tbb::this_task_arena::max_concurrency());
+			for (int taskCounter = 0; taskCounter < numberOfTasks; ++taskCounter) {
+
+				youngerBrothers.run([&]() {
+
+					GameBoardType brotherGameBoard = gameBoard;
+					WindowEvaluatorType brotherWindowEvaluator = windowEvaluator;
+					std::uint64_t brotherNodes = 0;
+
+					for (int moveCounter = nextMove.fetch_add(1); moveCounter < numberOfMoves && !isSearchAborted(); moveCounter = nextMove.fetch_add(1)) {
+
+						int columnPlayed = moves[moveCounter];
+						long long brotherAlpha = sharedAlpha.load();
+						int score = searchMove(brotherGameBoard, brotherWindowEvaluator, columnPlayed, depth, brotherAlpha, brotherAlpha + 1, isUserCoin, brotherNodes);
+						if (score > brotherAlpha && score < beta) {
+							score = searchMove(brotherGameBoard, brotherWindowEvaluator, columnPlayed, depth, brotherAlpha, beta, isUserCoin, brotherNodes);
+						}
+
+						//The score of a cancelled search is not reliable
+						if (isSearchAborted()) {
+							break;
+						}
+
+						tbb::spin_mutex::scoped_lock lock(bestScoreMutex);
+						if (score > bestScore) {
+							bestScore = score;
+							bestMove = columnPlayed;
+						}
+						if (score > sharedAlpha.load()) {
+							sharedAlpha.store(score);
+						}
+						if (score >= beta) {
+							youngerBrothers.cancel();
+						}
+					}
+
+					this->nodeCount.fetch_add(brotherNodes, std::memory_order_relaxed);
+				});
+			}
+
+			{
+				SearchStatsCounters::TaskWaitTimer taskWaitTimer(this->searchStatsCounters);
+				youngerBrothers.wait();
+			}
+			alpha = sharedAlpha.load();
+		}
+
+		//Best score the player to move can get within the search depth. The best move is returned through a parameter and
+		//the preferred move, if there is one, is searched first unless the move ordering says otherwise. The board is left
+		//as it was found.
+		int negamax(GameBoardType& gameBoard, WindowEvaluatorType& windowEvaluator, int depth, long long alpha, long long beta, bool isUserCoin, std::uint64_t& nodes, int& bestMove, int preferredMove) {
+
+			bestMove = -1;
+
+			//Nothing more to look at if maximum depth has been reached or if the board is full
+			if (depth == 0 || gameBoard.isFull()) {
+				return 0;
+			}
+
+			//Stop right away if the deadline has passed, the search was cancelled or a sibling of an ancestor has already
+			//cut this subtree off
+			if (isSearchAborted()) {
+				return 0;
+			}
+
+			//Threats that play out within the search depth can settle the position without searching it, and otherwise rule
+			//out the moves that lose on the next opponent move
+			ThreatFilterResult threatFilterResult = ThreatFilter::filterMoves(gameBoard, isUserCoin, depth);
+			if (threatFilterResult.outcome != ThreatOutcome::open) {
+				bestMove = ThreatFilter::getFirstColumn(threatFilterResult.columns);
+				return threatFilterResult.outcome == ThreatOutcome::loss ? -1 * HeuristicScorer::WINNING_SCORE : HeuristicScorer::WINNING_SCORE;
+			}
+
+			//A score saved at the same depth for the board or its mirror image can end the search here. Any saved best move
+			//is tried first.
+			long long alphaOriginal = alpha;
+			std::uint64_t positionKey = TranspositionTable::getKey(gameBoard.getCanonicalHash(), isUserCoin);
+			TranspositionTableEntry transpositionTableEntry;
+			int transpositionTableMove = -1;
+			bool isTranspositionTableHit = this->transpositionTable.probe(positionKey, transpositionTableEntry);
+			this->searchStatsCounters.countTranspositionTableProbe(isTranspositionTableHit);
+			if (isTranspositionTableHit) {
+
+				if (transpositionTableEntry.depth == depth &&
+					(transpositionTableEntry.scoreBound == ScoreBound::exact ||
+					(transpositionTableEntry.scoreBound == ScoreBound::lowerBound && transpositionTableEntry.score >= beta) ||
+					(transpositionTableEntry.scoreBound == ScoreBound::upperBound && transpositionTableEntry.score <= alpha))) {
+					bestMove = gameBoard.getCanonicalColumn(transpositionTableEntry.bestMove);
+					return transpositionTableEntry.score;
+				}
+
+				transpositionTableMove = gameBoard.getCanonicalColumn(transpositionTableEntry.bestMove);
+			}
+
+			int moves[GameBoardType::MAXIMUM_NUMBER_OF_COLUMNS];
+			int numberOfMoves = this->moveOrdering.orderMoves(gameBoard, isUserCoin, preferredMove, transpositionTableMove, moves, threatFilterResult.columns);
+
+			//Search the eldest brother on its own
+			int bestScore = searchMove(gameBoard, windowEvaluator, moves[0], depth, alpha, beta, isUserCoin, nodes);
+			bestMove = moves[0];
+			alpha = std::max(alpha, static_cast<long long>(bestScore));
+
+			if (alpha < beta && numberOfMoves > 1) {
+
+				if (depth >= MINIMUM_DEPTH_FOR_PARALLEL_SIBLINGS) {
+					searchYoungerBrothers(gameBoard, windowEvaluator, moves, numberOfMoves, depth, alpha, beta, isUserCoin, bestScore, bestMove);
+				}
+				else {
+					for (int moveCounter = 1; moveCounter < numberOfMoves && alpha < beta; ++moveCounter) {
+
+						int score = searchMove(gameBoard, windowEvaluator, moves[moveCounter], depth, alpha, alpha + 1, isUserCoin, nodes);
+						if (score > alpha && score < beta) {
+							score = searchMove(gameBoard, windowEvaluator, moves[moveCounter], depth, alpha, beta, isUserCoin, nodes);
+						}
+
+						if (score > bestScore) {
+							bestScore = score;
+							bestMove = moves[moveCounter];
+						}
+						alpha = std::max(alpha, static_cast<long long>(score));
+					}
+				}
+			}
+
+			//Do not save scores from a search that was stopped or cancelled part way through
+			if (isSearchAborted()) {
+				return bestScore;
+			}
+
+			ScoreBound scoreBound = ScoreBound::exact;
+			if (bestScore <= alphaOriginal) {
+				scoreBound = ScoreBound::upperBound;
+			}
+			else if (bestScore >= beta) {
+				scoreBound = ScoreBound::lowerBound;
+				this->moveOrdering.recordCutoff(gameBoard, bestMove, isUserCoin, depth);
+				this->searchStatsCounters.countCutoff();
+			}
+			this->transpositionTable.store(positionKey, depth, bestScore, scoreBound, gameBoard.getCanonicalColumn(bestMove));
+
+			return bestScore;
+		}
+
+	public:
+
+		BasicAlphaBetaSearch(const HeuristicScorer& heuristicScorer, TranspositionTable& transpositionTable) :
+			heuristicScorer(heuristicScorer), transpositionTable(transpositionTable), searchControl(nullptr), rootDepth(0), nodeCount(0), searchStopped(false), hasDeadline(false) {
+		}
+
+		void setMoveOrderingOptions(MoveOrderingOptions moveOrderingOptions) override {
+
+			this->moveOrdering.setOptions(moveOrderingOptions);
+		}
+
+		void setSearchControl(SearchControl* searchControl) override {
+
+			this->searchControl = searchControl;
+		}
+
+		//Find the best move for the player to move looking the given number of moves ahead
+		SearchResult search(const model::GameBoard& gameBoard, int depth, bool isUserCoin) override {
+
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			this->nodeCount.store(0);
+			this->searchStatsCounters.clear();
+			this->searchStopped.store(false);
+			this->hasDeadline = false;
+
+			SearchResult searchResult;
+			searchResult.searchAlgorithm = SearchAlgorithm::alphaBeta;
+			searchResult.depth = std::max(depth, 1);
+			this->rootDepth = searchResult.depth;
+
+			GameBoardType searchGameBoard(gameBoard);
+			WindowEvaluatorType windowEvaluator(searchGameBoard, this->heuristicScorer);
+			std::uint64_t nodes = 0;
+			searchResult.score = negamax(searchGameBoard, windowEvaluator, searchResult.depth, -1LL * INT_MAX, INT_MAX, isUserCoin, nodes, searchResult.bestMove, -1);
+			if (this->searchControl != nullptr && !isSearchStopped()) {
+				this->searchControl->reportProgress(searchResult.bestMove, searchResult.depth);
+			}
+
+			searchResult.nodes = this->nodeCount.fetch_add(nodes) + nodes;
+			searchResult.peakScratchMemory = 0;
+			searchResult.searchStats = this->searchStatsCounters.getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+			return searchResult;
+		}
+
+		//Search one move deeper at a time, starting from one move, until the time budget runs out. The best move of each
+		//depth is searched first at the next depth. The result is the one from the deepest search that finished, and
+		//its depth says how far the search got. The first depth is always finished so there is always a move, unless the
+		//search is cancelled.
+		SearchResult searchWithTimeBudget(const model::GameBoard& gameBoard, std::chrono::steady_clock::duration moveTimeBudget, bool isUserCoin) override {
+
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			this->nodeCount.store(0);
+			this->searchStatsCounters.clear();
+			this->searchStopped.store(false);
+			this->hasDeadline = false;
+			this->deadline = startTime + moveTimeBudget;
+
+			SearchResult searchResult;
+			searchResult.searchAlgorithm = SearchAlgorithm::alphaBeta;
+			searchResult.bestMove = -1;
+			searchResult.score = 0;
+			searchResult.depth = 0;
+
+			//There is no point looking further ahead than the number of empty slots
+			int numberOfEmptySlots = gameBoard.getNumberOfRows() * gameBoard.getNumberOfColumns() - gameBoard.getNumberOfCoins();
+
+			GameBoardType searchGameBoard(gameBoard);
+			WindowEvaluatorType windowEvaluator(searchGameBoard, this->heuristicScorer);
+			for (int depth = 1; depth <= numberOfEmptySlots; ++depth) {
+
+				std::uint64_t nodes = 0;
+				int bestMove;
+				this->rootDepth = depth;
+				int score = negamax(searchGameBoard, windowEvaluator, depth, -1LL * INT_MAX, INT_MAX, isUserCoin, nodes, bestMove, searchResult.bestMove);
+				this->nodeCount.fetch_add(nodes);
+
+				//Throw away the depth that ran out of time or was cancelled
+				if (isSearchStopped()) {
+					break;
+				}
+
+				searchResult.bestMove = bestMove;
+				searchResult.score = score;
+				searchResult.depth = depth;
+				if (this->searchControl != nullptr) {
+					this->searchControl->reportProgress(bestMove, depth);
+				}
+
+				//A forced win or loss does not change with more depth
+				if (score == HeuristicScorer::WINNING_SCORE || score == -1 * HeuristicScorer::WINNING_SCORE ||
+					std::chrono::steady_clock::now() >= this->deadline) {
+					break;
+				}
+
+				this->hasDeadline = true;
+			}
+
+			searchResult.nodes = this->nodeCount.load();
+			searchResult.peakScratchMemory = 0;
+			searchResult.searchStats = this->searchStatsCounters.getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+			return searchResult;
+		}
+
+	};
+
+	inline std::unique_ptr<AlphaBetaSearch> AlphaBetaSearch::create(int numberOfRows, int numberOfColumns, int winLength, const HeuristicScorer& heuristicScorer, TranspositionTable& transpositionTable) {
+
+		return model::createForBoardType<AlphaBetaSearch, BasicAlphaBetaSearch>(numberOfRows, numberOfColumns, winLength, heuristicScorer, transpositionTable);
+	}
+
+}
@@ -0,0 +1,417 @@
+#pragma once
+
+#include "GameBoard.hpp"
+#include "HeuristicScorer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define CONNECT_FOUR_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//GCC and Clang only emit vector instructions in functions marked for them unless the whole program is built for them.
+//Visual C++ allows them anywhere.
+#if defined(CONNECT_FOUR_X86) && !defined(_MSC_VER)
+#define CONNECT_FOUR_TARGET_SSE2 __attribute__((target("sse2")))
+#define CONNECT_FOUR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CONNECT_FOUR_TARGET_SSE2
+#define CONNECT_FOUR_TARGET_AVX2
+#endif
+
+namespace controller {
+
+	//Instruction set used to evaluate a batch of moves
+	enum class BatchKernel { scalar, sse2, avx2 };
+
+	//A move to score: the position, the column the coin is dropped into and whose coin it is. The column must have room.
+	//The position is kept on a one word board, the only size the evaluator takes, so gathering it reads a single word.
+	struct BatchedMove {
+		const model::SmallGameBoard* gameBoard;
+		int columnPlayed;
+		bool isUserCoin;
+	};
+
+	//Heuristic score of a batched move and whether it completes four in a row. A winning move scores the winning score.
+	struct BatchedMoveScore {
+		int score;
+		bool isWinningMove;
+	};
+
+	//Scores many moves at once, each on its own board, with the same result as WindowEvaluator::getMoveHueristicScore.
+	//The moves are gathered into arrays of bitboards and scored a few boards at a time with vector instructions, so a
+	//game server can pool the leaves of many shallow searches into one call. For each of the four directions the
+	//windows through the landing slot are found with shifts of the board mask, the windows holding an opponent coin are
+	//masked out and the coins of the player in the rest are counted with bit-sliced adders. The best kernel the
+	//processor supports is picked when the evaluator is made. All boards of a batch must have the evaluator's size, which
+	//has to fit into one word, and be played to four in a row.
+	class BatchEvaluator {
+
+	private:
+
+		//Constants
+		const static int NUMBER_OF_DIRECTIONS = 4;
+		const static std::size_t MOVES_PER_BLOCK = 256;
+
+		//Number of windows through the landing slot with no opponent coins that would hold one, two and three coins of the
+		//player after the move, and a non zero value if some window would be completed by the move
+		struct WindowCounts {
+			std::uint32_t oneCoinWindows;
+			std::uint32_t twoCoinWindows;
+			std::uint32_t threeCoinWindows;
+			std::uint32_t winningWindows;
+		};
+
+		//Members
+		const HeuristicScorer* heuristicScorer;
+		int numberOfRows, numberOfColumns;
+		std::uint64_t shifts[NUMBER_OF_DIRECTIONS];
+		std::uint64_t windowStarts[NUMBER_OF_DIRECTIONS];
+		BatchKernel batchKernel;
+
+		static std::uint64_t countBits(std::uint64_t bits) {
+
+			bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+			bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+			bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+			return (bits * 0x0101010101010101ULL) >> 56;
+
+		}
+
+		static bool isAvx2Supported() {
+
+#if defined(CONNECT_FOUR_X86) && defined(_MSC_VER)
+			int cpuInfo[4];
+			__cpuid(cpuInfo, 0);
+			if (cpuInfo[0] < 7) {
+				return false;
+			}
+
+			//The operating system has to save the vector registers as well
+			__cpuid(cpuInfo, 1);
+			bool hasAvx = (cpuInfo[2] & (1 << 27)) != 0 && (cpuInfo[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+			__cpuidex(cpuInfo, 7, 0);
+			return hasAvx && (cpuInfo[1] & (1 << 5)) != 0;
+#elif defined(CONNECT_FOUR_X86)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") != 0;
+#else
+			return false;
+#endif
+
+		}
+
+		static bool isSse2Supported() {
+
+#if defined(CONNECT_FOUR_X86) && (defined(_M_X64) || defined(__x86_64__))
+			return true;
+#elif defined(CONNECT_FOUR_X86) && defined(_MSC_VER)
+			int cpuInfo[4];
+			__cpuid(cpuInfo, 1);
+			return (cpuInfo[3] & (1 << 26)) != 0;
+#elif defined(CONNECT_FOUR_X86)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse2") != 0;
+#else
+			return false;
+#endif
+
+		}
+
+		//Count the windows of one move a direction at a time
+		void countWindowsScalar(const std::uint64_t* playerCoins, const std::uint64_t* opponentCoins, const std::uint64_t* dropBits, std::size_t numberOfMoves, WindowCounts* windowCounts) const {
+
+			for (std::size_t moveCounter = 0; moveCounter < numberOfMoves; ++moveCounter) {
+
+				WindowCounts counts = {};
+				for (int direction = 0; direction < NUMBER_OF_DIRECTIONS; ++direction) {
+
+					std::uint64_t shift = this->shifts[direction];
+					std::uint64_t player = playerCoins[moveCounter];
+					std::uint64_t opponent = opponentCoins[moveCounter];
+					std::uint64_t drop = dropBits[moveCounter];
+
+					//Windows are marked by the bit of their first slot, the lowest bit of the four
+					std::uint64_t windows = this->windowStarts[direction] &
+						(drop | (drop >> shift) | (drop >> (2 * shift)) | (drop >> (3 * shift))) &
+						~(opponent | (opponent >> shift) | (opponent >> (2 * shift)) | (opponent >> (3 * shift)));
+
+					//Add up the player coins of each window, two bits of the count at a time
+					std::uint64_t firstSum = player ^ (player >> shift), firstCarry = player & (player >> shift);
+					std::uint64_t secondSum = (player >> (2 * shift)) ^ (player >> (3 * shift)), secondCarry = (player >> (2 * shift)) & (player >> (3 * shift));
+					std::uint64_t lowBit = firstSum ^ secondSum;
+					std::uint64_t highBit = firstCarry ^ secondCarry ^ (firstSum & secondSum);
+
+					counts.oneCoinWindows += static_cast<std::uint32_t>(countBits(windows & ~highBit & ~lowBit));
+					counts.twoCoinWindows += static_cast<std::uint32_t>(countBits(windows & ~highBit & lowBit));
+					counts.threeCoinWindows += static_cast<std::uint32_t>(countBits(windows & highBit & ~lowBit));
+					counts.winningWindows |= (windows & highBit & lowBit) != 0 ? 1 : 0;
+				}
+
+				windowCounts[moveCounter] = counts;
+			}
+
+		}
+
+#ifdef CONNECT_FOUR_X86
+
+		//Count the bits of each lane. SSE2 has no bit count, so count within each byte and add up the bytes of a lane.
+		CONNECT_FOUR_TARGET_SSE2
+		static __m128i countLaneBitsSse2(__m128i bits) {
+
+			bits = _mm_sub_epi8(bits, _mm_and_si128(_mm_srli_epi64(bits, 1), _mm_set1_epi8(0x55)));
+			bits = _mm_add_epi8(_mm_and_si128(bits, _mm_set1_epi8(0x33)), _mm_and_si128(_mm_srli_epi64(bits, 2), _mm_set1_epi8(0x33)));
+			bits = _mm_and_si128(_mm_add_epi8(bits, _mm_srli_epi64(bits, 4)), _mm_set1_epi8(0x0F));
+			return _mm_sad_epu8(bits, _mm_setzero_si128());
+
+		}
+
+		//Count the bits of each lane by looking up the count of every half byte and adding up the bytes of a lane
+		CONNECT_FOUR_TARGET_AVX2
+		static __m256i countLaneBitsAvx2(__m256i bits) {
+
+			const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const __m256i nibbleBits = _mm256_set1_epi8(0x0F);
+			__m256i lowNibbles = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(bits, nibbleBits));
+			__m256i highNibbles = _mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(_mm256_srli_epi64(bits, 4), nibbleBits));
+			return _mm256_sad_epu8(_mm256_add_epi8(lowNibbles, highNibbles), _mm256_setzero_si256());
+
+		}
+
+		//Count the windows of two moves at a time in the two 64 bit lanes of an SSE2 register
+		CONNECT_FOUR_TARGET_SSE2
+		void countWindowsSse2(const std::uint64_t* playerCoins, const std::uint64_t* opponentCoins, const std::uint64_t* dropBits, std::size_t numberOfMoves, WindowCounts* windowCounts) const {
+
+			const __m128i zero = _mm_setzero_si128();
+
+			std::size_t moveCounter = 0;
+			for (; moveCounter + 2 <= numberOfMoves; moveCounter += 2) {
+
+				__m128i player = _mm_loadu_si128(reinterpret_cast<const __m128i*>(playerCoins + moveCounter));
+				__m128i opponent = _mm_loadu_si128(reinterpret_cast<const __m128i*>(opponentCoins + moveCounter));
+				__m128i drop = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dropBits + moveCounter));
+				__m128i oneCoinWindows = zero, twoCoinWindows = zero, threeCoinWindows = zero, winningWindows = zero;
+
+				for (int direction = 0; direction < NUMBER_OF_DIRECTIONS; ++direction) {
+
+					__m128i shift = _mm_cvtsi32_si128(static_cast<int>(this->shifts[direction]));
+					__m128i doubleShift = _mm_cvtsi32_si128(static_cast<int>(2 * this->shifts[direction]));
+					__m128i tripleShift = _mm_cvtsi32_si128(static_cast<int>(3 * this->shifts[direction]));
+					__m128i windowStarts = _mm_set1_epi64x(static_cast<long long>(this->windowStarts[direction]));
+
+					__m128i dropWindows = _mm_or_si128(_mm_or_si128(drop, _mm_srl_epi64(drop, shift)), _mm_or_si128(_mm_srl_epi64(drop, doubleShift), _mm_srl_epi64(drop, tripleShift)));
+					__m128i opponentWindows = _mm_or_si128(_mm_or_si128(opponent, _mm_srl_epi64(opponent, shift)), _mm_or_si128(_mm_srl_epi64(opponent, doubleShift), _mm_srl_epi64(opponent, tripleShift)));
+					__m128i windows = _mm_andnot_si128(opponentWindows, _mm_and_si128(windowStarts, dropWindows));
+
+					__m128i player1 = _mm_srl_epi64(player, shift), player2 = _mm_srl_epi64(player, doubleShift), player3 = _mm_srl_epi64(player, tripleShift);
+					__m128i firstSum = _mm_xor_si128(player, player1), firstCarry = _mm_and_si128(player, player1);
+					__m128i secondSum = _mm_xor_si128(player2, player3), secondCarry = _mm_and_si128(player2, player3);
+					__m128i lowBit = _mm_xor_si128(firstSum, secondSum);
+					__m128i highBit = _mm_xor_si128(_mm_xor_si128(firstCarry, secondCarry), _mm_and_si128(firstSum, secondSum));
+
+					oneCoinWindows = _mm_add_epi64(oneCoinWindows, countLaneBitsSse2(_mm_andnot_si128(_mm_or_si128(highBit, lowBit), windows)));
+					twoCoinWindows = _mm_add_epi64(twoCoinWindows, countLaneBitsSse2(_mm_andnot_si128(highBit, _mm_and_si128(windows, lowBit))));
+					threeCoinWindows = _mm_add_epi64(threeCoinWindows, countLaneBitsSse2(_mm_andnot_si128(lowBit, _mm_and_si128(windows, highBit))));
+					winningWindows = _mm_or_si128(winningWindows, _mm_and_si128(windows, _mm_and_si128(highBit, lowBit)));
+				}
+
+				std::uint64_t laneCounts[4][2];
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(laneCounts[0]), oneCoinWindows);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(laneCounts[1]), twoCoinWindows);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(laneCounts[2]), threeCoinWindows);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(laneCounts[3]), winningWindows);
+				for (int lane = 0; lane < 2; ++lane) {
+					windowCounts[moveCounter + lane].oneCoinWindows = static_cast<std::uint32_t>(laneCounts[0][lane]);
+					windowCounts[moveCounter + lane].twoCoinWindows = static_cast<std::uint32_t>(laneCounts[1][lane]);
+					windowCounts[moveCounter + lane].threeCoinWindows = static_cast<std::uint32_t>(laneCounts[2][lane]);
+					windowCounts[moveCounter + lane].winningWindows = laneCounts[3][lane] != 0 ? 1 : 0;
+				}
+			}
+
+			countWindowsScalar(playerCoins + moveCounter, opponentCoins + moveCounter, dropBits + moveCounter, numberOfMoves - moveCounter, windowCounts + moveCounter);
+
+		}
+
+		//Count the windows of four moves at a time in the four 64 bit lanes of an AVX2 register
+		CONNECT_FOUR_TARGET_AVX2
+		void countWindowsAvx2(const std::uint64_t* playerCoins, const std::uint64_t* opponentCoins, const std::uint64_t* dropBits, std::size_t numberOfMoves, WindowCounts* windowCounts) const {
+
+			const __m256i zero = _mm256_setzero_si256();
+
+			std::size_t moveCounter = 0;
+			for (; moveCounter + 4 <= numberOfMoves; moveCounter += 4) {
+
+				__m256i player = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(playerCoins + moveCounter));
+				__m256i opponent = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(opponentCoins + moveCounter));
+				__m256i drop = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dropBits + moveCounter));
+				__m256i oneCoinWindows = zero, twoCoinWindows = zero, threeCoinWindows = zero, winningWindows = zero;
+
+				for (int direction = 0; direction < NUMBER_OF_DIRECTIONS; ++direction) {
+
+					__m128i shift = _mm_cvtsi32_si128(static_cast<int>(this->shifts[direction]));
+					__m128i doubleShift = _mm_cvtsi32_si128(static_cast<int>(2 * this->shifts[direction]));
+					__m128i tripleShift = _mm_cvtsi32_si128(static_cast<int>(3 * this->shifts[direction]));
+					__m256i windowStarts = _mm256_set1_epi64x(static_cast<long long>(this->windowStarts[direction]));
+
+					__m256i dropWindows = _mm256_or_si256(_mm256_or_si256(drop, _mm256_srl_epi64(drop, shift)), _mm256_or_si256(_mm256_srl_epi64(drop, doubleShift), _mm256_srl_epi64(drop, tripleShift)));
+					__m256i opponentWindows = _mm256_or_si256(_mm256_or_si256(opponent, _mm256_srl_epi64(opponent, shift)), _mm256_or_si256(_mm256_srl_epi64(opponent, doubleShift), _mm256_srl_epi64(opponent, tripleShift)));
+					__m256i windows = _mm256_andnot_si256(opponentWindows, _mm256_and_si256(windowStarts, dropWindows));
+
+					__m256i player1 = _mm256_srl_epi64(player, shift), player2 = _mm256_srl_epi64(player, doubleShift), player3 = _mm256_srl_epi64(player, tripleShift);
+					__m256i firstSum = _mm256_xor_si256(player, player1), firstCarry = _mm256_and_si256(player, player1);
+					__m256i secondSum = _mm256_xor_si256(player2, player3), secondCarry = _mm256_and_si256(player2, player3);
+					__m256i lowBit = _mm256_xor_si256(firstSum, secondSum);
+					__m256i highBit = _mm256_xor_si256(_mm256_xor_si256(firstCarry, secondCarry), _mm256_and_si256(firstSum, secondSum));
+
+					oneCoinWindows = _mm256_add_epi64(oneCoinWindows, countLaneBitsAvx2(_mm256_andnot_si256(_mm256_or_si256(highBit, lowBit), windows)));
+					twoCoinWindows = _mm256_add_epi64(twoCoinWindows, countLaneBitsAvx2(_mm256_andnot_si256(highBit, _mm256_and_si256(windows, lowBit))));
+					threeCoinWindows = _mm256_add_epi64(threeCoinWindows, countLaneBitsAvx2(_mm256_andnot_si256(lowBit, _mm256_and_si256(windows, highBit))));
+					winningWindows = _mm256_or_si256(winningWindows, _mm256_and_si256(windows, _mm256_and_si256(highBit, lowBit)));
+				}
+
+				std::uint64_t laneCounts[4][4];
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(laneCounts[0]), oneCoinWindows);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(laneCounts[1]), twoCoinWindows);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(laneCounts[2]), threeCoinWindows);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(laneCounts[3]), winningWindows);
+				for (int lane = 0; lane < 4; ++lane) {
+					windowCounts[moveCounter + lane].oneCoinWindows = static_cast<std::uint32_t>(laneCounts[0][lane]);
+					windowCounts[moveCounter + lane].twoCoinWindows = static_cast<std::uint32_t>(laneCounts[1][lane]);
+					windowCounts[moveCounter + lane].threeCoinWindows = static_cast<std::uint32_t>(laneCounts[2][lane]);
+					windowCounts[moveCounter + lane].winningWindows = laneCounts[3][lane] != 0 ? 1 : 0;
+				}
+			}
+
+			countWindowsScalar(playerCoins + moveCounter, opponentCoins + moveCounter, dropBits + moveCounter, numberOfMoves - moveCounter, windowCounts + moveCounter);
+
+		}
+
+#endif
+
+		void countWindows(const std::uint64_t* playerCoins, const std::uint64_t* opponentCoins, const std::uint64_t* dropBits, std::size_t numberOfMoves, WindowCounts* windowCounts) const {
+
+#ifdef CONNECT_FOUR_X86
+			if (this->batchKernel == BatchKernel::avx2) {
+				countWindowsAvx2(playerCoins, opponentCoins, dropBits, numberOfMoves, windowCounts);
+				return;
+			}
+			else if (this->batchKernel == BatchKernel::sse2) {
+				countWindowsSse2(playerCoins, opponentCoins, dropBits, numberOfMoves, windowCounts);
+				return;
+			}
+#endif
+			countWindowsScalar(playerCoins, opponentCoins, dropBits, numberOfMoves, windowCounts);
+
+		}
+
+	public:
+
+		//Set up the window masks for boards of the given size and pick the fastest kernel
+		BatchEvaluator(int numberOfRows, int numberOfColumns, const HeuristicScorer& heuristicScorer) {
+
+			//Checks that the board fits into one word
+			model::SmallGameBoard gameBoard(numberOfRows, numberOfColumns);
+
+			this->heuristicScorer = &heuristicScorer;
+			this->numberOfRows = numberOfRows;
+			this->numberOfColumns = numberOfColumns;
+
+			//Vertical, horizontal and the two diagonals. A window is on the board if all four of its slots are.
+			std::uint64_t boardMask = 0;
+			for (int columnNumber = 0; columnNumber < numberOfColumns; ++columnNumber) {
+				boardMask |= ((std::uint64_t(1) << numberOfRows) - 1) << (columnNumber * (numberOfRows + 1));
+			}
+			const int directionShifts[NUMBER_OF_DIRECTIONS] = { 1, numberOfRows + 1, numberOfRows, numberOfRows + 2 };
+			for (int direction = 0; direction < NUMBER_OF_DIRECTIONS; ++direction) {
+				std::uint64_t shift = static_cast<std::uint64_t>(directionShifts[direction]);
+				this->shifts[direction] = shift;
+				this->windowStarts[direction] = boardMask & (boardMask >> shift) & (boardMask >> (2 * shift)) & (boardMask >> (3 * shift));
+			}
+
+			if (isAvx2Supported()) {
+				this->batchKernel = BatchKernel::avx2;
+			}
+			else if (isSse2Supported()) {
+				this->batchKernel = BatchKernel::sse2;
+			}
+			else {
+				this->batchKernel = BatchKernel::scalar;
+			}
+		}
+
+		BatchKernel getKernel() const {
+
+			return this->batchKernel;
+
+		}
+
+		//Use a slower kernel, for instance to compare them. Returns false and keeps the current kernel if the processor
+		//does not support the one asked for.
+		bool setKernel(BatchKernel batchKernel) {
+
+			if ((batchKernel == BatchKernel::avx2 && !isAvx2Supported()) || (batchKernel == BatchKernel::sse2 && !isSse2Supported())) {
+				return false;
+			}
+
+			this->batchKernel = batchKernel;
+			return true;
+
+		}
+
+		//Score every move of the batch into the matching slot of moveScores
+		void evaluateMoves(const BatchedMove* batchedMoves, std::size_t numberOfMoves, BatchedMoveScore* moveScores) const {
+
+			std::uint64_t playerCoins[MOVES_PER_BLOCK], opponentCoins[MOVES_PER_BLOCK], dropBits[MOVES_PER_BLOCK];
+			WindowCounts windowCounts[MOVES_PER_BLOCK];
+
+			for (std::size_t blockStart = 0; blockStart < numberOfMoves; blockStart += MOVES_PER_BLOCK) {
+
+				//Gather the bitboards of a block of moves
+				std::size_t blockSize = numberOfMoves - blockStart < MOVES_PER_BLOCK ? numberOfMoves - blockStart : MOVES_PER_BLOCK;
+				for (std::size_t moveCounter = 0; moveCounter < blockSize; ++moveCounter) {
+
+					const BatchedMove& batchedMove = batchedMoves[blockStart + moveCounter];
+					if (batchedMove.gameBoard->getNumberOfRows() != this->numberOfRows || batchedMove.gameBoard->getNumberOfColumns() != this->numberOfColumns ||
+						batchedMove.gameBoard->getWinLength() != HeuristicScorer::COINS_IN_A_ROW_TO_WIN) {
+						std::stringstream errorMessage;
+						errorMessage << "Move " << blockStart + moveCounter << " of the batch is on a board with " << batchedMove.gameBoard->getNumberOfRows() << " rows and " <<
+							batchedMove.gameBoard->getNumberOfColumns() << " columns played to " << batchedMove.gameBoard->getWinLength() << " in a row instead of " <<
+							this->numberOfRows << " rows and " << this->numberOfColumns << " columns played to four in a row.";
+						throw std::logic_error(errorMessage.str());
+					}
+
+					playerCoins[moveCounter] = batchedMove.gameBoard->getCoinBits(batchedMove.isUserCoin).getWord(0);
+					opponentCoins[moveCounter] = batchedMove.gameBoard->getCoinBits(batchedMove.isUserCoin ? false : true).getWord(0);
+					dropBits[moveCounter] = batchedMove.gameBoard->getDropBit(batchedMove.columnPlayed).getWord(0);
+				}
+
+				countWindows(playerCoins, opponentCoins, dropBits, blockSize, windowCounts);
+
+				//Weigh the window counts with the scores of the scorer
+				for (std::size_t moveCounter = 0; moveCounter < blockSize; ++moveCounter) {
+
+					BatchedMoveScore& moveScore = moveScores[blockStart + moveCounter];
+					moveScore.isWinningMove = windowCounts[moveCounter].winningWindows != 0;
+					if (moveScore.isWinningMove) {
+						moveScore.score = HeuristicScorer::WINNING_SCORE;
+					}
+					else {
+						moveScore.score = static_cast<int>(windowCounts[moveCounter].oneCoinWindows) * this->heuristicScorer->getWindowScore(1) +
+							static_cast<int>(windowCounts[moveCounter].twoCoinWindows) * this->heuristicScorer->getWindowScore(2) +
+							static_cast<int>(windowCounts[moveCounter].threeCoinWindows) * this->heuristicScorer->getWindowScore(3);
+					}
+				}
+			}
+
+		}
+
+	};
+
+}
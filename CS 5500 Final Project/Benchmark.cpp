@@ -0,0 +1,302 @@
+#include <tbb\global_control.h>
+
+#include "ConnectFourGame.hpp"
+#include "GameBoard.hpp"
+#include "SearchResult.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	//Constants for default values
+	const int DEFAULT_MAXIMUM_DEPTH = 10;
+	const int NUMBER_OF_ROWS = 6;
+	const int NUMBER_OF_COLUMNS = 7;
+	const int SEARCH_DEPTHS[] = { 4, 6, 8, 10, 12 };
+	const int BOARD_SIZE_SEARCH_DEPTH = 6;
+
+	//Position reached by playing the columns in turn, the user first. Each one has the computer to move.
+	struct BenchmarkPosition {
+		const char* phase;
+		const char* moves;
+	};
+
+	//Fixed set of positions so that results can be compared between releases. Do not change them, add new ones.
+	const BenchmarkPosition BENCHMARK_POSITIONS[] = {
+		{ "opening", "3" },
+		{ "opening", "343" },
+		{ "opening", "33245" },
+		{ "midgame", "245422053" },
+		{ "midgame", "23223432324" },
+		{ "midgame", "4423232213340" },
+		{ "midgame", "303023002531525" },
+		{ "endgame", "244311435456233214142203603" },
+		{ "endgame", "32242321654233001423436046605" },
+		{ "endgame", "2363053332453546246006566410201" }
+	};
+
+	//Board and the number of coins in a row that wins on it
+	struct BenchmarkBoardSize {
+		int numberOfRows;
+		int numberOfColumns;
+		int winLength;
+	};
+
+	//Boards from Connect Four up to five in a row on 20 by 20, to see how the search copes as the board grows
+	const BenchmarkBoardSize BENCHMARK_BOARD_SIZES[] = {
+		{ 6, 7, 4 },
+		{ 7, 8, 4 },
+		{ 8, 9, 4 },
+		{ 10, 10, 5 },
+		{ 15, 15, 5 },
+		{ 20, 20, 5 }
+	};
+
+	//One search of one position
+	struct BenchmarkRun {
+		int positionNumber;
+		int depth;
+		int numberOfThreads;
+		controller::SearchResult searchResult;
+		bool agreesWithOneThread;
+	};
+
+	//One search of the opening of one board size
+	struct BoardSizeRun {
+		int boardSizeNumber;
+		int numberOfThreads;
+		controller::SearchResult searchResult;
+	};
+
+	//Totals of all the searches run with the same number of threads
+	struct ThreadCountSummary {
+		int numberOfThreads;
+		std::uint64_t nodes;
+		std::int64_t elapsedMicroseconds;
+		int agreements;
+		int numberOfRuns;
+	};
+
+	model::GameBoard setUpPosition(const BenchmarkPosition& benchmarkPosition) {
+
+		model::GameBoard gameBoard(NUMBER_OF_ROWS, NUMBER_OF_COLUMNS);
+		bool isUserCoin = true;
+		for (const char* move = benchmarkPosition.moves; *move != '\0'; ++move) {
+
+			int columnNumber = *move - '0';
+			if (!gameBoard.isValidColumn(columnNumber) || !gameBoard.canDropCoin(columnNumber) || gameBoard.isWinningDrop(columnNumber, isUserCoin)) {
+				std::stringstream errorMessage;
+				errorMessage << "Benchmark position " << benchmarkPosition.moves << " does not lead to a game in progress.";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			gameBoard.dropCoin(columnNumber, isUserCoin);
+			isUserCoin = isUserCoin ? false : true;
+		}
+
+		return gameBoard;
+	}
+
+	//Search the computer move in a new game so that no run starts with positions scored by an earlier one
+	controller::SearchResult searchPosition(const model::GameBoard& gameBoard, int depth) {
+
+		controller::ConnectFourGame connectFourGame(NUMBER_OF_ROWS, NUMBER_OF_COLUMNS);
+		connectFourGame.setGameBoard(gameBoard);
+		connectFourGame.setgameDifficultyLevel(depth);
+		return connectFourGame.searchComputerMove(controller::SearchAlgorithm::alphaBeta);
+	}
+
+	//Opening of a board of the size with three coins around the center, the user first, so that it has the computer to move
+	model::GameBoard setUpOpening(const BenchmarkBoardSize& boardSize) {
+
+		model::GameBoard gameBoard(boardSize.numberOfRows, boardSize.numberOfColumns, boardSize.winLength);
+		int centerColumn = boardSize.numberOfColumns / 2;
+		gameBoard.dropCoin(centerColumn, true);
+		gameBoard.dropCoin(centerColumn, false);
+		gameBoard.dropCoin(centerColumn - 1, true);
+		return gameBoard;
+	}
+
+	//Search the computer move on a board of the size in a new game
+	controller::SearchResult searchOpening(const BenchmarkBoardSize& boardSize, const model::GameBoard& gameBoard, int depth) {
+
+		controller::ConnectFourGame connectFourGame(boardSize.numberOfRows, boardSize.numberOfColumns, boardSize.winLength);
+		connectFourGame.setGameBoard(gameBoard);
+		connectFourGame.setgameDifficultyLevel(depth);
+		return connectFourGame.searchComputerMove(controller::SearchAlgorithm::alphaBeta);
+	}
+
+	double getNodesPerSecond(std::uint64_t nodes, std::int64_t elapsedMicroseconds) {
+
+		return elapsedMicroseconds > 0 ? nodes * 1000000.0 / elapsedMicroseconds : 0.0;
+	}
+
+	void writeJson(std::ostream& jsonFile, int maximumNumberOfThreads, const std::vector<BenchmarkRun>& benchmarkRuns, const std::vector<ThreadCountSummary>& summaries,
+		int boardSizeDepth, const std::vector<BoardSizeRun>& boardSizeRuns) {
+
+		jsonFile << std::fixed << std::setprecision(3);
+		jsonFile << "{\n";
+		jsonFile << "  \"rows\": " << NUMBER_OF_ROWS << ",\n";
+		jsonFile << "  \"columns\": " << NUMBER_OF_COLUMNS << ",\n";
+		jsonFile << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+		jsonFile << "  \"maximumThreads\": " << maximumNumberOfThreads << ",\n";
+
+		jsonFile << "  \"positions\": [\n";
+		int numberOfPositions = sizeof(BENCHMARK_POSITIONS) / sizeof(BENCHMARK_POSITIONS[0]);
+		for (int positionCounter = 0; positionCounter < numberOfPositions; ++positionCounter) {
+			jsonFile << "    { \"phase\": \"" << BENCHMARK_POSITIONS[positionCounter].phase << "\", \"moves\": \"" << BENCHMARK_POSITIONS[positionCounter].moves << "\" }" <<
+				(positionCounter + 1 < numberOfPositions ? "," : "") << "\n";
+		}
+		jsonFile << "  ],\n";
+
+		jsonFile << "  \"runs\": [\n";
+		for (std::size_t runCounter = 0; runCounter < benchmarkRuns.size(); ++runCounter) {
+			const BenchmarkRun& benchmarkRun = benchmarkRuns[runCounter];
+			jsonFile << "    { \"position\": " << benchmarkRun.positionNumber << ", \"depth\": " << benchmarkRun.depth << ", \"threads\": " << benchmarkRun.numberOfThreads <<
+				", \"bestMove\": " << benchmarkRun.searchResult.bestMove << ", \"score\": " << benchmarkRun.searchResult.score <<
+				", \"nodes\": " << benchmarkRun.searchResult.nodes << ", \"microseconds\": " << benchmarkRun.searchResult.elapsedTime.count() <<
+				", \"nodesPerSecond\": " << getNodesPerSecond(benchmarkRun.searchResult.nodes, benchmarkRun.searchResult.elapsedTime.count()) <<
+				", \"agreesWithOneThread\": " << (benchmarkRun.agreesWithOneThread ? "true" : "false") << " }" <<
+				(runCounter + 1 < benchmarkRuns.size() ? "," : "") << "\n";
+		}
+		jsonFile << "  ],\n";
+
+		jsonFile << "  \"threadScaling\": [\n";
+		for (std::size_t summaryCounter = 0; summaryCounter < summaries.size(); ++summaryCounter) {
+			const ThreadCountSummary& summary = summaries[summaryCounter];
+			double speedup = summary.elapsedMicroseconds > 0 ? static_cast<double>(summaries[0].elapsedMicroseconds) / summary.elapsedMicroseconds : 0.0;
+			jsonFile << "    { \"threads\": " << summary.numberOfThreads << ", \"nodes\": " << summary.nodes << ", \"microseconds\": " << summary.elapsedMicroseconds <<
+				", \"nodesPerSecond\": " << getNodesPerSecond(summary.nodes, summary.elapsedMicroseconds) << ", \"speedup\": " << speedup <<
+				", \"efficiency\": " << speedup / summary.numberOfThreads << ", \"agreements\": " << summary.agreements << ", \"runs\": " << summary.numberOfRuns << " }" <<
+				(summaryCounter + 1 < summaries.size() ? "," : "") << "\n";
+		}
+		jsonFile << "  ],\n";
+
+		jsonFile << "  \"boardSizeDepth\": " << boardSizeDepth << ",\n";
+		jsonFile << "  \"boardSizes\": [\n";
+		for (std::size_t runCounter = 0; runCounter < boardSizeRuns.size(); ++runCounter) {
+			const BoardSizeRun& boardSizeRun = boardSizeRuns[runCounter];
+			const BenchmarkBoardSize& boardSize = BENCHMARK_BOARD_SIZES[boardSizeRun.boardSizeNumber];
+			jsonFile << "    { \"rows\": " << boardSize.numberOfRows << ", \"columns\": " << boardSize.numberOfColumns << ", \"winLength\": " << boardSize.winLength <<
+				", \"threads\": " << boardSizeRun.numberOfThreads << ", \"bestMove\": " << boardSizeRun.searchResult.bestMove <<
+				", \"nodes\": " << boardSizeRun.searchResult.nodes << ", \"microseconds\": " << boardSizeRun.searchResult.elapsedTime.count() <<
+				", \"nodesPerSecond\": " << getNodesPerSecond(boardSizeRun.searchResult.nodes, boardSizeRun.searchResult.elapsedTime.count()) << " }" <<
+				(runCounter + 1 < boardSizeRuns.size() ? "," : "") << "\n";
+		}
+		jsonFile << "  ]\n";
+		jsonFile << "}\n";
+	}
+
+}
+
+//Search a fixed set of opening, midgame and endgame positions at several depths with 1 to N threads. Reports the nodes
+//per second, the time to reach each depth, how often the best move matches the one found with a single thread, and
+//the parallel efficiency of each thread count. Then searches the opening of boards from 6 by 7 up to 20 by 20 to show
+//how the nodes per second hold up as the board grows. The results are also written as JSON to track them between
+//releases.
+//Usage: Benchmark [json file] [maximum threads] [maximum depth]
+int main(int argc, char* argv[]) {
+
+	const char* jsonFilePath = argc > 1 ? argv[1] : nullptr;
+	int maximumNumberOfThreads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+	int maximumDepth = argc > 3 ? std::atoi(argv[3]) : DEFAULT_MAXIMUM_DEPTH;
+	maximumNumberOfThreads = std::max(maximumNumberOfThreads, 1);
+
+	std::vector<model::GameBoard> gameBoards;
+	for (const BenchmarkPosition& benchmarkPosition : BENCHMARK_POSITIONS) {
+		gameBoards.push_back(setUpPosition(benchmarkPosition));
+	}
+
+	std::vector<BenchmarkRun> benchmarkRuns, oneThreadRuns;
+	std::vector<ThreadCountSummary> summaries;
+	for (int numberOfThreads = 1; numberOfThreads <= maximumNumberOfThreads; ++numberOfThreads) {
+
+		tbb::global_control threadLimit(tbb::global_control::max_allowed_parallelism, numberOfThreads);
+		ThreadCountSummary summary = { numberOfThreads, 0, 0, 0, 0 };
+
+		std::cout << "Threads: " << numberOfThreads << std::endl;
+		for (std::size_t positionCounter = 0; positionCounter < gameBoards.size(); ++positionCounter) {
+
+			std::cout << "  " << std::setw(7) << BENCHMARK_POSITIONS[positionCounter].phase << " " << std::setw(32) << std::left << BENCHMARK_POSITIONS[positionCounter].moves << std::right;
+			for (int depth : SEARCH_DEPTHS) {
+
+				if (depth > maximumDepth) {
+					continue;
+				}
+
+				BenchmarkRun benchmarkRun;
+				benchmarkRun.positionNumber = static_cast<int>(positionCounter);
+				benchmarkRun.depth = depth;
+				benchmarkRun.numberOfThreads = numberOfThreads;
+				benchmarkRun.searchResult = searchPosition(gameBoards[positionCounter], depth);
+
+				//The parallel search may settle ties differently, so compare with the single thread search
+				if (numberOfThreads == 1) {
+					oneThreadRuns.push_back(benchmarkRun);
+				}
+				benchmarkRun.agreesWithOneThread = benchmarkRun.searchResult.bestMove == oneThreadRuns[benchmarkRuns.size() % oneThreadRuns.size()].searchResult.bestMove;
+				benchmarkRuns.push_back(benchmarkRun);
+
+				summary.nodes += benchmarkRun.searchResult.nodes;
+				summary.elapsedMicroseconds += benchmarkRun.searchResult.elapsedTime.count();
+				summary.agreements += benchmarkRun.agreesWithOneThread ? 1 : 0;
+				++summary.numberOfRuns;
+
+				std::cout << " d" << depth << " " << std::setw(9) << benchmarkRun.searchResult.elapsedTime.count() << "us";
+			}
+			std::cout << std::endl;
+		}
+
+		summaries.push_back(summary);
+		double speedup = static_cast<double>(summaries[0].elapsedMicroseconds) / std::max<std::int64_t>(summary.elapsedMicroseconds, 1);
+		std::cout << "  " << summary.nodes << " nodes in " << summary.elapsedMicroseconds << " us, " << static_cast<std::uint64_t>(getNodesPerSecond(summary.nodes, summary.elapsedMicroseconds)) <<
+			" nodes/s, speedup " << speedup << ", efficiency " << speedup / numberOfThreads << ", " << summary.agreements << " of " << summary.numberOfRuns << " best moves agree" << std::endl;
+	}
+
+	//The larger boards have more moves at every node, so they are searched less deep
+	int boardSizeDepth = std::min(BOARD_SIZE_SEARCH_DEPTH, maximumDepth);
+	std::vector<BoardSizeRun> boardSizeRuns;
+	std::cout << "Board sizes at depth " << boardSizeDepth << ", nodes/s by number of threads" << std::endl;
+	int numberOfBoardSizes = sizeof(BENCHMARK_BOARD_SIZES) / sizeof(BENCHMARK_BOARD_SIZES[0]);
+	for (int boardSizeCounter = 0; boardSizeCounter < numberOfBoardSizes; ++boardSizeCounter) {
+
+		const BenchmarkBoardSize& boardSize = BENCHMARK_BOARD_SIZES[boardSizeCounter];
+		model::GameBoard gameBoard = setUpOpening(boardSize);
+		std::stringstream boardName;
+		boardName << boardSize.numberOfRows << "x" << boardSize.numberOfColumns << " " << boardSize.winLength << " in a row";
+		std::cout << "  " << std::setw(18) << std::left << boardName.str() << std::right;
+
+		for (int numberOfThreads = 1; numberOfThreads <= maximumNumberOfThreads; ++numberOfThreads) {
+
+			tbb::global_control threadLimit(tbb::global_control::max_allowed_parallelism, numberOfThreads);
+			BoardSizeRun boardSizeRun;
+			boardSizeRun.boardSizeNumber = boardSizeCounter;
+			boardSizeRun.numberOfThreads = numberOfThreads;
+			boardSizeRun.searchResult = searchOpening(boardSize, gameBoard, boardSizeDepth);
+			boardSizeRuns.push_back(boardSizeRun);
+
+			std::cout << " " << std::setw(11) << static_cast<std::uint64_t>(getNodesPerSecond(boardSizeRun.searchResult.nodes, boardSizeRun.searchResult.elapsedTime.count()));
+		}
+		std::cout << std::endl;
+	}
+
+	if (jsonFilePath != nullptr) {
+		std::ofstream jsonFile(jsonFilePath);
+		writeJson(jsonFile, maximumNumberOfThreads, benchmarkRuns, summaries, boardSizeDepth, boardSizeRuns);
+		if (!jsonFile) {
+			std::cerr << "Cannot write " << jsonFilePath << std::endl;
+			return 1;
+		}
+		std::cout << "Wrote " << jsonFilePath << std::endl;
+	}
+
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <cstdint>
+
+namespace model {
+
+	//Bitboard of a fixed number of 64 bit words, the lowest bit in the lowest word. Shifts and additions carry bits from
+	//one word into the next, so a board too large for one word is checked with the same shifts as a small one. A
+	//bitboard of one word compiles down to plain operations on the word.
+	template <int NUMBER_OF_WORDS>
+	class BasicBitboard {
+
+		template <int> friend class BasicBitboard;
+
+	public:
+
+		//Number of bits in a word
+		const static int BITS_IN_WORD = 64;
+
+		//Number of bits in the bitboard
+		const static int NUMBER_OF_BITS = NUMBER_OF_WORDS * BITS_IN_WORD;
+
+	private:
+
+		static_assert(NUMBER_OF_WORDS > 0, "A bitboard has at least one word.");
+
+		//Members
+		std::uint64_t words[NUMBER_OF_WORDS];
+
+	public:
+
+		//Empty bitboard
+		BasicBitboard() : words() {
+		}
+
+		//Bitboard with the word as its lowest bits
+		explicit BasicBitboard(std::uint64_t lowestWord) : words() {
+
+			this->words[0] = lowestWord;
+
+		}
+
+		//Copy a bitboard of another size. Bits that do not fit are dropped.
+		template <int OTHER_NUMBER_OF_WORDS>
+		explicit BasicBitboard(const BasicBitboard<OTHER_NUMBER_OF_WORDS>& bitboard) : words() {
+
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS && wordCounter < OTHER_NUMBER_OF_WORDS; ++wordCounter) {
+				this->words[wordCounter] = bitboard.words[wordCounter];
+			}
+
+		}
+
+		//Return a bitboard with only the given bit set
+		static BasicBitboard getBit(int bitNumber) {
+
+			BasicBitboard bitboard;
+			bitboard.words[bitNumber / BITS_IN_WORD] = std::uint64_t(1) << (bitNumber % BITS_IN_WORD);
+			return bitboard;
+
+		}
+
+		bool hasBit(int bitNumber) const {
+
+			return ((this->words[bitNumber / BITS_IN_WORD] >> (bitNumber % BITS_IN_WORD)) & 1) != 0;
+
+		}
+
+		void setBit(int bitNumber) {
+
+			this->words[bitNumber / BITS_IN_WORD] |= std::uint64_t(1) << (bitNumber % BITS_IN_WORD);
+
+		}
+
+		void clearBit(int bitNumber) {
+
+			this->words[bitNumber / BITS_IN_WORD] &= ~(std::uint64_t(1) << (bitNumber % BITS_IN_WORD));
+
+		}
+
+		std::uint64_t getWord(int wordNumber) const {
+
+			return this->words[wordNumber];
+
+		}
+
+		//Return up to 64 bits starting at the given bit, such as the bits of one column
+		std::uint64_t getBits(int firstBitNumber, int numberOfBits) const {
+
+			int wordNumber = firstBitNumber / BITS_IN_WORD, bitShift = firstBitNumber % BITS_IN_WORD;
+			std::uint64_t bits = this->words[wordNumber] >> bitShift;
+			if (bitShift != 0 && wordNumber + 1 < NUMBER_OF_WORDS) {
+				bits |= this->words[wordNumber + 1] << (BITS_IN_WORD - bitShift);
+			}
+			return numberOfBits < BITS_IN_WORD ? bits & ((std::uint64_t(1) << numberOfBits) - 1) : bits;
+
+		}
+
+		bool isEmpty() const {
+
+			std::uint64_t anyBits = 0;
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				anyBits |= this->words[wordCounter];
+			}
+			return anyBits == 0;
+
+		}
+
+		explicit operator bool() const {
+
+			return !isEmpty();
+
+		}
+
+		bool hasMoreThanOneBit() const {
+
+			if constexpr (NUMBER_OF_WORDS == 1) {
+				return (this->words[0] & (this->words[0] - 1)) != 0;
+			}
+			else {
+				bool hasBit = false;
+				for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+					if (this->words[wordCounter] != 0) {
+						if (hasBit || (this->words[wordCounter] & (this->words[wordCounter] - 1)) != 0) {
+							return true;
+						}
+						hasBit = true;
+					}
+				}
+				return false;
+			}
+
+		}
+
+		BasicBitboard operator~() const {
+
+			BasicBitboard result;
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				result.words[wordCounter] = ~this->words[wordCounter];
+			}
+			return result;
+
+		}
+
+		BasicBitboard& operator&=(const BasicBitboard& other) {
+
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				this->words[wordCounter] &= other.words[wordCounter];
+			}
+			return *this;
+
+		}
+
+		BasicBitboard& operator|=(const BasicBitboard& other) {
+
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				this->words[wordCounter] |= other.words[wordCounter];
+			}
+			return *this;
+
+		}
+
+		BasicBitboard& operator^=(const BasicBitboard& other) {
+
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				this->words[wordCounter] ^= other.words[wordCounter];
+			}
+			return *this;
+
+		}
+
+		BasicBitboard operator&(const BasicBitboard& other) const {
+
+			BasicBitboard result = *this;
+			return result &= other;
+
+		}
+
+		BasicBitboard operator|(const BasicBitboard& other) const {
+
+			BasicBitboard result = *this;
+			return result |= other;
+
+		}
+
+		BasicBitboard operator^(const BasicBitboard& other) const {
+
+			BasicBitboard result = *this;
+			return result ^= other;
+
+		}
+
+		//Shift towards the higher bits. Bits shifted past the top are dropped.
+		BasicBitboard operator<<(int shift) const {
+
+			BasicBitboard result;
+			if constexpr (NUMBER_OF_WORDS == 1) {
+				result.words[0] = shift < BITS_IN_WORD ? this->words[0] << shift : 0;
+			}
+			else {
+				int wordShift = shift / BITS_IN_WORD, bitShift = shift % BITS_IN_WORD;
+				for (int wordCounter = NUMBER_OF_WORDS - 1; wordCounter >= wordShift; --wordCounter) {
+					result.words[wordCounter] = this->words[wordCounter - wordShift] << bitShift;
+					if (bitShift != 0 && wordCounter - wordShift - 1 >= 0) {
+						result.words[wordCounter] |= this->words[wordCounter - wordShift - 1] >> (BITS_IN_WORD - bitShift);
+					}
+				}
+			}
+			return result;
+
+		}
+
+		//Shift towards the lower bits. Bits shifted past the bottom are dropped.
+		BasicBitboard operator>>(int shift) const {
+
+			BasicBitboard result;
+			if constexpr (NUMBER_OF_WORDS == 1) {
+				result.words[0] = shift < BITS_IN_WORD ? this->words[0] >> shift : 0;
+			}
+			else {
+				int wordShift = shift / BITS_IN_WORD, bitShift = shift % BITS_IN_WORD;
+				for (int wordCounter = 0; wordCounter + wordShift < NUMBER_OF_WORDS; ++wordCounter) {
+					result.words[wordCounter] = this->words[wordCounter + wordShift] >> bitShift;
+					if (bitShift != 0 && wordCounter + wordShift + 1 < NUMBER_OF_WORDS) {
+						result.words[wordCounter] |= this->words[wordCounter + wordShift + 1] << (BITS_IN_WORD - bitShift);
+					}
+				}
+			}
+			return result;
+
+		}
+
+		//Add as one long number. A carry out of the top word is dropped.
+		BasicBitboard operator+(const BasicBitboard& other) const {
+
+			BasicBitboard result;
+			std::uint64_t carry = 0;
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				std::uint64_t sum = this->words[wordCounter] + other.words[wordCounter];
+				std::uint64_t carryOut = sum < this->words[wordCounter] ? 1 : 0;
+				result.words[wordCounter] = sum + carry;
+				carry = carryOut | (result.words[wordCounter] < sum ? 1 : 0);
+			}
+			return result;
+
+		}
+
+		//Subtract as one long number. A borrow out of the top word is dropped.
+		BasicBitboard operator-(const BasicBitboard& other) const {
+
+			BasicBitboard result;
+			std::uint64_t borrow = 0;
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				std::uint64_t difference = this->words[wordCounter] - other.words[wordCounter];
+				std::uint64_t borrowOut = this->words[wordCounter] < other.words[wordCounter] ? 1 : 0;
+				result.words[wordCounter] = difference - borrow;
+				borrow = borrowOut | (difference < borrow ? 1 : 0);
+			}
+			return result;
+
+		}
+
+		bool operator==(const BasicBitboard& other) const {
+
+			std::uint64_t differentBits = 0;
+			for (int wordCounter = 0; wordCounter < NUMBER_OF_WORDS; ++wordCounter) {
+				differentBits |= this->words[wordCounter] ^ other.words[wordCounter];
+			}
+			return differentBits == 0;
+
+		}
+
+		bool operator!=(const BasicBitboard& other) const {
+
+			return !(*this == other);
+
+		}
+
+	};
+
+}
@@ -0,0 +1,93 @@
+#include "AlphaBetaSearch.hpp"
+#include "GameBoard.hpp"
+#include "HeuristicScorer.hpp"
+#include "OpeningBook.hpp"
+#include "TranspositionTable.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	//Constants for default values
+	const int DEFAULT_NUMBER_OF_PLIES = 4;
+	const int DEFAULT_SEARCH_DEPTH = 12;
+	const int DEFAULT_NUMBER_OF_ROWS = 6;
+	const int DEFAULT_NUMBER_OF_COLUMNS = 7;
+	const std::size_t TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES = 256;
+
+	//Collect every position with the computer to move that can come up within the given number of coins, whichever
+	//player went first. Positions where someone has already won are left out, and a position and its mirror image are
+	//collected once.
+	void collectComputerPositions(model::GameBoard& gameBoard, bool isUserToMove, int pliesLeft, std::map<std::uint64_t, model::GameBoard>& computerPositions) {
+
+		if (!isUserToMove) {
+			computerPositions.emplace(controller::TranspositionTable::getKey(gameBoard.getCanonicalHash(), false), gameBoard);
+		}
+
+		if (pliesLeft == 0) {
+			return;
+		}
+
+		for (int columnNumber = 0; columnNumber < gameBoard.getNumberOfColumns(); ++columnNumber) {
+			if (gameBoard.canDropCoin(columnNumber) && !gameBoard.isWinningDrop(columnNumber, isUserToMove)) {
+				gameBoard.dropCoin(columnNumber, isUserToMove);
+				collectComputerPositions(gameBoard, isUserToMove ? false : true, pliesLeft - 1, computerPositions);
+				gameBoard.undoCoin(columnNumber);
+			}
+		}
+	}
+
+}
+
+//Build the opening book read by ConnectFourGame::setOpeningBook by searching every early position deeply.
+//Usage: BuildOpeningBook <book file> [plies] [depth] [rows] [columns]
+int main(int argc, char* argv[]) {
+
+	if (argc < 2) {
+		std::cerr << "Usage: BuildOpeningBook <book file> [plies] [depth] [rows] [columns]" << std::endl;
+		return 1;
+	}
+
+	const char* bookFilePath = argv[1];
+	int numberOfPlies = argc > 2 ? std::atoi(argv[2]) : DEFAULT_NUMBER_OF_PLIES;
+	int searchDepth = argc > 3 ? std::atoi(argv[3]) : DEFAULT_SEARCH_DEPTH;
+	int numberOfRows = argc > 4 ? std::atoi(argv[4]) : DEFAULT_NUMBER_OF_ROWS;
+	int numberOfColumns = argc > 5 ? std::atoi(argv[5]) : DEFAULT_NUMBER_OF_COLUMNS;
+
+	//Start from an empty board with either player to move first
+	std::map<std::uint64_t, model::GameBoard> computerPositions;
+	model::GameBoard gameBoard(numberOfRows, numberOfColumns);
+	collectComputerPositions(gameBoard, true, numberOfPlies, computerPositions);
+	collectComputerPositions(gameBoard, false, numberOfPlies, computerPositions);
+	std::cout << "Searching " << computerPositions.size() << " positions to depth " << searchDepth << std::endl;
+
+	controller::HeuristicScorer heuristicScorer;
+	controller::TranspositionTable transpositionTable(TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES);
+	std::unique_ptr<controller::AlphaBetaSearch> alphaBetaSearch = controller::AlphaBetaSearch::create(numberOfRows, numberOfColumns, gameBoard.getWinLength(), heuristicScorer, transpositionTable);
+
+	std::vector<controller::OpeningBookEntry> entries;
+	for (const std::pair<const std::uint64_t, model::GameBoard>& computerPosition : computerPositions) {
+
+		controller::SearchResult searchResult = alphaBetaSearch->search(computerPosition.second, searchDepth, false);
+
+		controller::OpeningBookEntry entry = {};
+		entry.key = computerPosition.first;
+		entry.score = searchResult.score;
+		entry.depth = static_cast<std::uint8_t>(searchResult.depth);
+		entry.bestMove = static_cast<std::int8_t>(computerPosition.second.getCanonicalColumn(searchResult.bestMove));
+		entries.push_back(entry);
+
+		if (entries.size() % 100 == 0) {
+			std::cout << entries.size() << " of " << computerPositions.size() << " positions searched" << std::endl;
+		}
+	}
+
+	controller::OpeningBook::write(bookFilePath, numberOfRows, numberOfColumns, entries);
+	std::cout << "Wrote " << entries.size() << " positions to " << bookFilePath << std::endl;
+
+}
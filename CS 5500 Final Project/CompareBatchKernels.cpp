@@ -0,0 +1,127 @@
+#include "BatchEvaluator.hpp"
+#include "GameBoard.hpp"
+#include "HeuristicScorer.hpp"
+#include "WindowEvaluator.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+	//Constants for default values
+	const std::size_t NUMBER_OF_MOVES = 20000;
+	const int TIMING_REPETITIONS = 50;
+	const int BOARD_SIZES[][2] = { { 6, 7 }, { 7, 8 }, { 5, 4 }, { 4, 9 } };
+
+	const char* getKernelName(controller::BatchKernel batchKernel) {
+
+		switch (batchKernel) {
+		case controller::BatchKernel::sse2:
+			return "SSE2";
+		case controller::BatchKernel::avx2:
+			return "AVX2";
+		default:
+			return "scalar";
+		}
+	}
+
+	//Random position of the given size with at least one column that still has room
+	model::SmallGameBoard playRandomPosition(int numberOfRows, int numberOfColumns, std::mt19937& randomNumbers) {
+
+		while (true) {
+			model::SmallGameBoard gameBoard(numberOfRows, numberOfColumns);
+			bool isUserCoin = randomNumbers() % 2 == 0;
+			int numberOfCoins = static_cast<int>(randomNumbers() % (numberOfRows * numberOfColumns - 2));
+			for (int coinCounter = 0; coinCounter < numberOfCoins; ++coinCounter) {
+				int columnNumber = static_cast<int>(randomNumbers() % numberOfColumns);
+				if (gameBoard.canDropCoin(columnNumber)) {
+					gameBoard.dropCoin(columnNumber, isUserCoin);
+					isUserCoin = !isUserCoin;
+				}
+			}
+
+			if (!gameBoard.isFull()) {
+				return gameBoard;
+			}
+		}
+	}
+
+	//Score random moves on boards of one size with every kernel the processor supports and count the scores that differ
+	//from the window evaluator. Returns the number of mismatches.
+	int compareKernels(int numberOfRows, int numberOfColumns) {
+
+		controller::HeuristicScorer heuristicScorer;
+		std::mt19937 randomNumbers(numberOfRows * 100 + numberOfColumns);
+
+		std::vector<model::SmallGameBoard> gameBoards;
+		gameBoards.reserve(NUMBER_OF_MOVES);
+		while (gameBoards.size() < NUMBER_OF_MOVES) {
+			gameBoards.push_back(playRandomPosition(numberOfRows, numberOfColumns, randomNumbers));
+		}
+
+		std::vector<controller::BatchedMove> batchedMoves;
+		std::vector<int> expectedScores;
+		for (const model::SmallGameBoard& gameBoard : gameBoards) {
+			int columnNumber;
+			do {
+				columnNumber = static_cast<int>(randomNumbers() % numberOfColumns);
+			} while (!gameBoard.canDropCoin(columnNumber));
+			bool isUserCoin = randomNumbers() % 2 == 0;
+
+			controller::BatchedMove batchedMove = { &gameBoard, columnNumber, isUserCoin };
+			batchedMoves.push_back(batchedMove);
+			controller::BasicWindowEvaluator<model::SmallGameBoard> windowEvaluator(gameBoard, heuristicScorer);
+			expectedScores.push_back(windowEvaluator.getMoveHueristicScore(gameBoard, columnNumber, isUserCoin));
+		}
+
+		int numberOfMismatches = 0;
+		std::vector<controller::BatchedMoveScore> moveScores(batchedMoves.size());
+		controller::BatchEvaluator batchEvaluator(numberOfRows, numberOfColumns, heuristicScorer);
+		for (controller::BatchKernel batchKernel : { controller::BatchKernel::scalar, controller::BatchKernel::sse2, controller::BatchKernel::avx2 }) {
+
+			if (!batchEvaluator.setKernel(batchKernel)) {
+				std::cout << numberOfRows << "x" << numberOfColumns << " " << getKernelName(batchKernel) << ": not supported by this processor" << std::endl;
+				continue;
+			}
+
+			batchEvaluator.evaluateMoves(batchedMoves.data(), batchedMoves.size(), moveScores.data());
+			int kernelMismatches = 0;
+			for (std::size_t moveCounter = 0; moveCounter < batchedMoves.size(); ++moveCounter) {
+				bool isWinningMove = expectedScores[moveCounter] == controller::HeuristicScorer::WINNING_SCORE;
+				if (moveScores[moveCounter].score != expectedScores[moveCounter] || moveScores[moveCounter].isWinningMove != isWinningMove) {
+					++kernelMismatches;
+				}
+			}
+			numberOfMismatches += kernelMismatches;
+
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			for (int repetitionCounter = 0; repetitionCounter < TIMING_REPETITIONS; ++repetitionCounter) {
+				batchEvaluator.evaluateMoves(batchedMoves.data(), batchedMoves.size(), moveScores.data());
+			}
+			double nanosecondsPerMove = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / (TIMING_REPETITIONS * batchedMoves.size());
+
+			std::cout << numberOfRows << "x" << numberOfColumns << " " << getKernelName(batchKernel) << ": " << kernelMismatches << " mismatches in " << batchedMoves.size() <<
+				" moves, " << std::fixed << std::setprecision(2) << nanosecondsPerMove << " ns/move" << std::endl;
+		}
+
+		return numberOfMismatches;
+	}
+
+}
+
+//Check that the scalar, SSE2 and AVX2 kernels of the batch evaluator score random moves the same as the window
+//evaluator, on boards of several sizes, and time each kernel. Exits with 1 if any score differs.
+int main() {
+
+	int numberOfMismatches = 0;
+	for (const int* boardSize : BOARD_SIZES) {
+		numberOfMismatches += compareKernels(boardSize[0], boardSize[1]);
+	}
+
+	std::cout << numberOfMismatches << " mismatches in total" << std::endl;
+	return numberOfMismatches == 0 ? 0 : 1;
+
+}
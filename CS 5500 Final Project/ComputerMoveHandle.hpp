@@ -0,0 +1,130 @@
+#pragma once
+
+#include "SearchControl.hpp"
+#include "SearchResult.hpp"
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+
+namespace controller {
+
+	//Handle to a computer move being computed in the background by ConnectFourGame::dropCoinAsync. It can be polled for
+	//the best move found so far, waited on, or cancelled, for example when the user resigns or leaves. A cancelled
+	//search stops within a few nodes and the computer does not play its move.
+	class ComputerMoveHandle {
+
+	private:
+
+		//Members
+		SearchControl searchControl;
+		std::promise<SearchResult> resultPromise;
+		std::shared_future<SearchResult> result;
+		std::function<void(const SearchResult&)> onComplete;
+		std::promise<void> finishedPromise;
+		std::shared_future<void> finished;
+
+	public:
+
+		//The callback, if there is one, is called on the thread that computed the move once the result is ready, so it can
+		//read the result from the handle or play the next move
+		explicit ComputerMoveHandle(std::function<void(const SearchResult&)> onComplete) : onComplete(onComplete) {
+
+			this->result = this->resultPromise.get_future().share();
+			this->finished = this->finishedPromise.get_future().share();
+
+		}
+
+		ComputerMoveHandle(const ComputerMoveHandle&) = delete;
+		ComputerMoveHandle& operator=(const ComputerMoveHandle&) = delete;
+
+		void cancel() {
+
+			this->searchControl.cancel();
+
+		}
+
+		bool isCancelled() const {
+
+			return this->searchControl.isCancelled();
+
+		}
+
+		//Check if the move has been computed, or given up on if it was cancelled
+		bool isDone() const {
+
+			return this->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+
+		}
+
+		//Best move of the deepest search finished so far, or -1 if none has finished yet
+		int getCurrentBestMove() const {
+
+			return this->searchControl.getCurrentBestMove();
+
+		}
+
+		int getCurrentDepth() const {
+
+			return this->searchControl.getCurrentDepth();
+
+		}
+
+		void wait() const {
+
+			this->result.wait();
+
+		}
+
+		//Wait until the callback has returned as well, for instance before the game it plays on goes away
+		void waitUntilFinished() const {
+
+			this->finished.wait();
+
+		}
+
+		//Wait for the result. The best move is -1 if the computer did not get to move because the user move was not
+		//valid or ended the game.
+		SearchResult getResult() const {
+
+			return this->result.get();
+
+		}
+
+		SearchControl& getSearchControl() {
+
+			return this->searchControl;
+
+		}
+
+		//Hand over the result of the search. Called once by the thread that computed the move.
+		void complete(const SearchResult& searchResult) {
+
+			this->resultPromise.set_value(searchResult);
+
+			//The computer has already moved, so an error from the callback cannot take the place of the result. There is
+			//no caller on this thread to hand it to either.
+			try {
+				if (this->onComplete) {
+					this->onComplete(searchResult);
+				}
+			}
+			catch (...) {
+			}
+
+			this->finishedPromise.set_value();
+
+		}
+
+		//Hand over the error that stopped the search
+		void fail(std::exception_ptr error) {
+
+			this->resultPromise.set_exception(error);
+			this->finishedPromise.set_value();
+
+		}
+
+	};
+
+}
@@ -1,13 +1,39 @@
+#pragma once
+
 #include <tbb\blocked_range.h>
+#include <tbb\combinable.h>
 #include <tbb\parallel_for.h>
+#include <tbb\task_arena.h>
 
+#include "AlphaBetaSearch.hpp"
+#include "ComputerMoveHandle.hpp"
+#include "EndgameSolver.hpp"
 #include "GameBoard.hpp"
 #include "GameSlot.hpp"
+#include "HeuristicScorer.hpp"
+#include "MonteCarloTreeSearch.hpp"
+#include "MoveOrdering.hpp"
+#include "OpeningBook.hpp"
+#include "ScratchArena.hpp"
+#include "SearchControl.hpp"
+#include "SearchResult.hpp"
+#include "SearchStats.hpp"
+#include "SolvedPositionStore.hpp"
+#include "ThreatFilter.hpp"
+#include "TranspositionTable.hpp"
+#include "WindowEvaluator.hpp"
 
 #include <algorithm> 
 #include <cassert>
+#include <chrono>
 #include <climits>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -20,15 +46,34 @@ namespace controller {
 		//Constants
 		const static bool DEFAULT_FIRST_PLAYER_IS_USER = true;
 		const static int DEFAULT_DIFFICULTY_LEVEL = 2;
-		const static int HEURISTIC_SCORE_FOR_ONE_IN_ROW = 1;
-		const static int HEURISTIC_SCORE_FOR_TWO_IN_ROW = 3;
-		const static int HEURISTIC_SCORE_FOR_THREE_IN_ROW = 9;
-		const static int HEURISTIC_SCORE_FOR_FOUR_IN_ROW = INT_MAX;
-		const static int COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW = 3;
+		const static std::size_t DEFAULT_TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES = 16;
+		const static SearchAlgorithm DEFAULT_SEARCH_ALGORITHM = SearchAlgorithm::alphaBeta;
+		const static int DEFAULT_ENDGAME_SOLVER_THRESHOLD = 20;
+		const static int PLAYOUTS_PER_DIFFICULTY_LEVEL = 2000;
 
 		int gameDifficultyLevel;
 		bool firstPlayerIsUser;
 		model::GameBoard gameBoard;
+		HeuristicScorer heuristicScorer;
+		TranspositionTable transpositionTable;
+		SearchAlgorithm searchAlgorithm;
+		MoveOrderingOptions moveOrderingOptions;
+		PlayoutPolicy playoutPolicy;
+		std::unique_ptr<MonteCarloTreeSearch> monteCarloTreeSearch;
+		std::shared_ptr<const OpeningBook> openingBook;
+		std::shared_ptr<SolvedPositionStore> solvedPositionStore;
+		int endgameSolverThreshold;
+		std::chrono::steady_clock::duration moveTimeBudget;
+		SearchResult lastSearchResult;
+		tbb::combinable<std::uint64_t> minimaxNodeCounts;
+		SearchStatsCounters minimaxSearchStats;
+		ScratchArena minimaxScratchArena;
+		int minimaxDepth;
+		SearchControl* searchControl;
+		std::shared_ptr<ComputerMoveHandle> computerMove;
+		tbb::task_arena computerMoveArena;
+		bool ponderingEnabled;
+		std::shared_ptr<ComputerMoveHandle> ponderSearch;
 
 		//Check if this is a valid play given the game board dimensions and coins already played
 		bool isValidPlay(int dropInColumn) {
@@ -51,387 +96,483 @@ namespace controller {
 
 		}
 
-		//Return the index corresponding to the top available position
-		int getAvailableSlot(int columnNumber) {
-
-			//Make sure that this is a valid play
-			assert(isValidPlay(columnNumber));
-
-			//Find the top and bottom rows in the columns
-			int bottomRowInColumn = columnNumber + this->gameBoard.getNumberOfColumns() * (this->gameBoard.getNumberOfRows() - 1);
-			int topRowInColumn = columnNumber;
+		//Drop a coin into one of the columns
+		void dropCoin(int dropInColumn, bool isUserCoin) {
 
-			//Start with bottom row and go one cell above at a time till an empty one is found
-			for (int slotCounter = bottomRowInColumn; slotCounter >= topRowInColumn; slotCounter -= this->gameBoard.getNumberOfColumns()) {
-				if (this->gameBoard.isEmptyAt(slotCounter)) {
-					return slotCounter;
-				}
+			if (playUserCoin(dropInColumn, isUserCoin)) {
+				playComputerMove();
 			}
-
-			//Exit the program as if it reaches here as this should never happen
-			assert(false);
-
-			return 0;
 		}
 
-		//Drop a coin into one of the columns
-		void dropCoin(int dropInColumn, bool isUserCoin) {
+		//Drop the user coin if the play is a valid one. Returns true if the computer has to reply.
+		bool playUserCoin(int dropInColumn, bool isUserCoin) {
 
 			//First check if the play is a valid one
 			if (this->isValidPlay(dropInColumn)) {
 
 				//Place a user coin in the top available position
-				this->gameBoard.getGameSlot(getAvailableSlot(dropInColumn)).putCoin(isUserCoin);
+				this->gameBoard.dropCoin(dropInColumn, isUserCoin);
 
-				if (wasWinningPlay(dropInColumn, true)) {
+				if (wasWinningPlay(true)) {
 					endTheGame(true);
+					return false;
 				}
-				else {
-					//Make a move to best counter the user move
-					int columnToPlay = counterUserMove();
-					int rowToPlay = getAvailableSlot(columnToPlay);
-					this->gameBoard.getGameSlot(this->gameBoard.getBoardIndex(rowToPlay, columnToPlay)).putCoin(false);
-				}
+
+				return !this->gameBoard.isFull();
+			}
+			else {
+				return false;
 			}
 		}
 
-		//Check if the last play was a winning play
-		bool wasWinningPlay(int columnPlayed, bool isUserCoin) {
+		//Make a move to best counter the user move. A cancelled search does not get to play its move.
+		void playComputerMove() {
 
-			//Compute hueristic scores for horizontal, vertical and diagonal four coins in a row resulting from 
-			//coin being dropped in column
-			int horizontalHueristicScore = getHorizontalHueristicScore(columnPlayed, gameBoard, isUserCoin);
-			int verticalHueristicScore = getVerticalHueristicScore(columnPlayed, gameBoard, isUserCoin);
-			int positiveSlopeHueristicScore = getPositiveSlopeHueristicScore(columnPlayed, gameBoard, isUserCoin);
-			int negativeSlopeHueristicScore = getNegativeSlopeHueristicScore(columnPlayed, gameBoard, isUserCoin);
+			int columnToPlay = counterUserMove();
+			if (this->searchControl != nullptr && this->searchControl->isCancelled()) {
+				return;
+			}
 
-			//If it was a winning move, then return with indicator saying so
-			if (horizontalHueristicScore == INT_MAX ||
-				verticalHueristicScore == INT_MAX ||
-				positiveSlopeHueristicScore == INT_MAX ||
-				negativeSlopeHueristicScore == INT_MAX) {
+			this->gameBoard.dropCoin(columnToPlay, false);
 
-				return true;
+			if (wasWinningPlay(false)) {
+				endTheGame(false);
 			}
-			else {
-				return false;
+			else if (this->ponderingEnabled && !this->gameBoard.isFull()) {
+				startPondering();
 			}
 		}
 
-		//Show message saying who won and disable game controls
-		void endTheGame(bool userWon) {
+		//Think about the computer replies to the likely user moves while the user is deciding. The pondering runs in the
+		//arena of the game on its own copy of the board and leaves its scores in the transposition table, where the
+		//search for the real reply finds them.
+		void startPondering() {
 
-			//TODO display message saying the user won/lost and disable game playing controls
-		}
+			std::shared_ptr<ComputerMoveHandle> ponderSearch(new ComputerMoveHandle(nullptr));
+			this->ponderSearch = ponderSearch;
 
-		//Consider all possible moves and play the one with the best hueristic score that maximizes the chance of winning 
-		int counterUserMove() {
+			model::GameBoard ponderGameBoard = this->gameBoard;
+			this->computerMoveArena.enqueue([this, ponderSearch, ponderGameBoard]() {
+
+				try {
+					ponder(ponderGameBoard, ponderSearch->getSearchControl());
+				}
+				catch (...) {
+					ponderSearch->fail(std::current_exception());
+					return;
+				}
 
-			std::vector<int> moveScores(this->gameBoard.getNumberOfColumns());
-			int depth = this->gameDifficultyLevel;
+				ponderSearch->complete(SearchResult());
+			});
+		}
 
-			//Find best move by considering all columns in parallel using the Map pattern
-			tbb::parallel_for(
-				tbb::blocked_range<int>(0, this->gameBoard.getNumberOfColumns() + 1),
-				[=, &moveScores](tbb::blocked_range<int> range) {
+		//Cancel the pondering and wait for its tasks to stop. The scores it finished stay in the transposition table.
+		void stopPondering() {
 
-				for (int columnCounter = range.begin(); columnCounter != range.end(); ++columnCounter) {
-					moveScores.at(columnCounter) = getMoveHueristicScore(depth, columnCounter, true, this->gameBoard);
-				}
+			if (this->ponderSearch) {
+				this->ponderSearch->cancel();
+				this->ponderSearch->wait();
+				this->ponderSearch.reset();
 			}
-			);
+		}
 
-			int bestMove = 0, bestScore = -1 * INT_MAX;
-			for (int moveCounter = 0; moveCounter < this->gameBoard.getNumberOfColumns(); ++moveCounter) {
-				if (moveScores.at(moveCounter) > bestScore) {
-					bestScore = moveScores.at(moveCounter);
-					bestMove = moveCounter;
-				}
-			}
+		//Make sure no search is running on the settings before one of them changes. A computer move still being computed
+		//has to be finished or cancelled first, and pondering is stopped. The description says which setting changes.
+		void stopSearchesForChange(const char* settingDescription) {
 
-			return bestMove;
+			if (isComputerMoveInProgress()) {
+				std::stringstream errorMessage;
+				errorMessage << "Cannot change the " << settingDescription << " while the computer move is still being computed.";
+				throw std::logic_error(errorMessage.str());
+			}
 
+			stopPondering();
 		}
 
-		//Compute best heuristic score for opponent move
-		int bestHeuristicScoreForOpponentMove(int depth, bool isUserCoin, model::GameBoard gameBoard) {
+		//Search the computer reply to each user move the way counterUserMove would, the user move the last search
+		//expected first and the rest from the center out, until all of them are searched or the user moves
+		void ponder(model::GameBoard ponderGameBoard, SearchControl& ponderSearchControl) {
 
-			std::vector<int> moveScores(gameBoard.getNumberOfColumns());
-			//Do a map to find the move with the highest score
-			tbb::parallel_for(
-				tbb::blocked_range<int>(0, this->gameBoard.getNumberOfColumns() + 1),
-				[=, &moveScores](tbb::blocked_range<int> range) {
+			//The minimax search only works on the board of the game, and the Monte Carlo tree is not kept between moves
+			if (this->searchAlgorithm == SearchAlgorithm::minimax || this->searchAlgorithm == SearchAlgorithm::monteCarloTreeSearch) {
+				return;
+			}
 
-				for (int columnCounter = range.begin(); columnCounter != range.end(); ++columnCounter) {
-					moveScores.at(columnCounter) = getMoveHueristicScore(depth, columnCounter, isUserCoin, gameBoard);
-				}
+			std::unique_ptr<AlphaBetaSearch> alphaBetaSearch = AlphaBetaSearch::create(ponderGameBoard.getNumberOfRows(), ponderGameBoard.getNumberOfColumns(), ponderGameBoard.getWinLength(), this->heuristicScorer, this->transpositionTable);
+			alphaBetaSearch->setMoveOrderingOptions(this->moveOrderingOptions);
+			alphaBetaSearch->setSearchControl(&ponderSearchControl);
+			std::unique_ptr<EndgameSolver> endgameSolver = EndgameSolver::create(ponderGameBoard.getNumberOfRows(), ponderGameBoard.getNumberOfColumns(), ponderGameBoard.getWinLength(), this->transpositionTable);
+			endgameSolver->setSearchControl(&ponderSearchControl);
+			endgameSolver->setSolvedPositionStore(this->solvedPositionStore.get());
+
+			//The search for the last computer move saved its best guess at the user reply
+			TranspositionTableEntry transpositionTableEntry;
+			int expectedUserMove = -1;
+			if (this->transpositionTable.probe(TranspositionTable::getKey(ponderGameBoard.getCanonicalHash(), true), transpositionTableEntry)) {
+				expectedUserMove = ponderGameBoard.getCanonicalColumn(transpositionTableEntry.bestMove);
 			}
-			);
 
-			int bestMove = 0, bestScore = -1 * INT_MAX;
-			for (int moveCounter = 0; moveCounter < gameBoard.getNumberOfColumns(); ++moveCounter) {
-				if (moveScores.at(moveCounter) > bestScore) {
-					bestScore = moveScores.at(moveCounter);
-					bestMove = moveCounter;
+			int userMoves[model::GameBoard::MAXIMUM_NUMBER_OF_COLUMNS];
+			int numberOfUserMoves = MoveOrdering().orderMoves(ponderGameBoard, true, expectedUserMove, -1, userMoves);
+
+			for (int moveCounter = 0; moveCounter < numberOfUserMoves && !ponderSearchControl.isCancelled(); ++moveCounter) {
+
+				//Nothing to reply to a winning user move
+				int userMove = userMoves[moveCounter];
+				if (ponderGameBoard.isWinningDrop(userMove, true)) {
+					continue;
 				}
-			}
 
-			return bestMove;
+				ponderGameBoard.dropCoin(userMove, true);
 
+				//Book moves and forced moves are played without searching
+				OpeningBookEntry openingBookEntry;
+				bool isBookPosition = this->openingBook && this->openingBook->lookUp(ponderGameBoard, false, openingBookEntry);
+				int numberOfEmptySlots = ponderGameBoard.getNumberOfRows() * ponderGameBoard.getNumberOfColumns() - ponderGameBoard.getNumberOfCoins();
+				if (!ponderGameBoard.isFull() && !isBookPosition && !ThreatFilter::isForced(ThreatFilter::filterMoves(ponderGameBoard, false, numberOfEmptySlots))) {
+					if (numberOfEmptySlots <= this->endgameSolverThreshold || this->searchAlgorithm == SearchAlgorithm::endgameSolver) {
+						endgameSolver->solve(ponderGameBoard, false);
+					}
+					else if (this->moveTimeBudget > std::chrono::steady_clock::duration::zero()) {
+						alphaBetaSearch->searchWithTimeBudget(ponderGameBoard, this->moveTimeBudget, false);
+					}
+					else {
+						alphaBetaSearch->search(ponderGameBoard, this->gameDifficultyLevel, false);
+					}
+				}
+
+				ponderGameBoard.undoCoin(userMove);
+			}
 		}
 
-		//Compute and return the hueristic score for the move
-		int getMoveHueristicScore(int depth, int columnPlayed, bool isUserCoin, model::GameBoard gameBoard) {
+		//Check if a computer move started by dropCoinAsync is still being computed
+		bool isComputerMoveInProgress() const {
 
-			//If maximum depth has been reached, then return
-			if (depth == 0) {
-				return 0;
-			}
-			
-			//Compute hueristic scores for horizontal, vertical and diagonal four coins in a row resulting from 
-			//coin being dropped in column
-			int horizontalHueristicScore = getHorizontalHueristicScore(columnPlayed, gameBoard, isUserCoin);
-			int verticalHueristicScore = getVerticalHueristicScore(columnPlayed, gameBoard, isUserCoin);
-			int positiveSlopeHueristicScore = getPositiveSlopeHueristicScore(columnPlayed, gameBoard, isUserCoin);
-			int negativeSlopeHueristicScore = getNegativeSlopeHueristicScore(columnPlayed, gameBoard, isUserCoin);
+			return this->computerMove && !this->computerMove->isDone();
 
-			//If it was a winning move, then return with indicator saying so
-			if (horizontalHueristicScore == INT_MAX ||
-				verticalHueristicScore == INT_MAX ||
-				positiveSlopeHueristicScore == INT_MAX ||
-				negativeSlopeHueristicScore == INT_MAX) {
+		}
 
-				return INT_MAX;
-			}
+		//Check if the last play was a winning play
+		bool wasWinningPlay(bool isUserCoin) {
 
-			int heuristicScoreForCurrentMove = horizontalHueristicScore +
-				                               verticalHueristicScore +
-				                               positiveSlopeHueristicScore +
-				                               negativeSlopeHueristicScore;
+			//The coin is already on the board so look for a winning line in the bitboard of the player
+			return this->gameBoard.hasWinningLine(isUserCoin);
+		}
 
-			//Make a copy of the current gameboard to simulate a dropped coin
-			model::GameBoard whatIfGameBoard = model::GameBoard(gameBoard);
-			whatIfGameBoard.forceDropCoin(columnPlayed, isUserCoin ? false : true);
+		//Show message saying who won and disable game controls
+		void endTheGame(bool userWon) {
 
-			return heuristicScoreForCurrentMove - bestHeuristicScoreForOpponentMove(depth - 1, isUserCoin ? false : true, whatIfGameBoard);
+			//TODO display message saying the user won/lost and disable game playing controls
 		}
 
-		//Check if the cells between from and to index are of the required type or empty. 
-		//Also count the number of cells of the required type.
-		bool isEmptyOrRequiredType(int fromIndex, int toIndex, bool userCoinPlayed, int& hueristicScore, model::GameBoard gameBoard) {
+		//Consider all possible moves and play the one with the best hueristic score that maximizes the chance of winning 
+		int counterUserMove() {
 
-			int coinCount = 0, nextRow, nextColumn, nextIndex;
-			bool firstTime = true;
+			//Play from the opening book if the position is in it, the move is forced or the position was solved before,
+			//and solve the game exactly once it is nearly over
+			if (searchOpeningBook(this->lastSearchResult) || searchForcedMove(this->lastSearchResult) || searchSolvedPositionStore(this->lastSearchResult)) {
+				return this->lastSearchResult.bestMove;
+			}
 
-			int fromRow = gameBoard.getRowNumber(fromIndex);
-			int fromColumn = gameBoard.getColumnNumber(fromIndex);
-			int toRow = gameBoard.getRowNumber(toIndex);
-			int toColumn = gameBoard.getColumnNumber(toIndex);
+			int numberOfEmptySlots = this->gameBoard.getNumberOfRows() * this->gameBoard.getNumberOfColumns() - this->gameBoard.getNumberOfCoins();
+			if (numberOfEmptySlots <= this->endgameSolverThreshold) {
+				this->lastSearchResult = searchComputerMove(SearchAlgorithm::endgameSolver);
+			}
+			else {
+				this->lastSearchResult = searchComputerMove(this->searchAlgorithm);
+			}
+			return this->lastSearchResult.bestMove;
 
-			for (int column = 0; column <= COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW; ++column) {
+		}
 
-				if (fromRow == toRow) {//horizontal sequence
-					nextRow = fromRow;
-					nextColumn = fromColumn + column;
-					nextIndex = gameBoard.getBoardIndex(nextRow, nextColumn);
-				}
-				else if (fromColumn == toColumn) {//vertical sequence
-					nextRow = fromRow + column;
-					nextColumn = fromColumn;
-					nextIndex = gameBoard.getBoardIndex(nextRow, nextColumn);
-				}
-				else if (fromRow > toRow && fromColumn < toColumn) {//diagonal going up
-					if (firstTime) {
-						firstTime = false;
-						nextIndex = fromIndex;
-					}
-					else {
-						nextIndex = gameBoard.getDiagonalCellToRightGoingUp(nextIndex);
-					}					
+		//Look the computer move up in the opening book. Returns true and fills in the result if the book has the position.
+		bool searchOpeningBook(SearchResult& searchResult) {
 
-				}
-				else if (fromRow < toRow && fromColumn < toColumn) {//diagonal going down
-					if (firstTime) {
-						firstTime = false;
-						nextIndex = fromIndex;
-					}
-					else {
-						nextIndex = gameBoard.getDiagonalCellToRightGoingDown(nextIndex);
-					}
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			OpeningBookEntry openingBookEntry;
+			if (!this->openingBook || !this->openingBook->lookUp(this->gameBoard, false, openingBookEntry) ||
+				!this->gameBoard.canDropCoin(openingBookEntry.bestMove)) {
+				return false;
+			}
 
-				}
+			searchResult.searchAlgorithm = SearchAlgorithm::openingBook;
+			searchResult.bestMove = openingBookEntry.bestMove;
+			searchResult.score = openingBookEntry.score;
+			searchResult.depth = openingBookEntry.depth;
+			searchResult.nodes = 0;
+			searchResult.peakScratchMemory = 0;
+			searchResult.searchStats = SearchStatsCounters().getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+			return true;
 
-				if (gameBoard.getGameSlot(nextIndex).hasComputerCoin()) {
-					if (userCoinPlayed) {
-						return false;
-					}
-					else {
-						++coinCount;
-					}
-				}
-				else if (gameBoard.getGameSlot(nextIndex).hasUserCoin()) {
-					if (userCoinPlayed) {
-						++coinCount;
-					}
-					else {
-						return false;
-					}
-				}
+		}
 
+		//Look the computer move up in the solved position store. Returns true and fills in the result if the position was
+		//solved before. The score is on the scale of the endgame solver and the depth is the number of empty slots.
+		bool searchSolvedPositionStore(SearchResult& searchResult) {
+
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			SolvedPosition solvedPosition;
+			if (!this->solvedPositionStore || !this->solvedPositionStore->lookUp(this->gameBoard, false, solvedPosition) ||
+				solvedPosition.bestMove < 0 || !this->gameBoard.canDropCoin(solvedPosition.bestMove)) {
+				return false;
 			}
 
-			if (coinCount == 1) {
-				hueristicScore = HEURISTIC_SCORE_FOR_ONE_IN_ROW;
+			searchResult.searchAlgorithm = SearchAlgorithm::solvedPositionStore;
+			searchResult.bestMove = solvedPosition.bestMove;
+			searchResult.score = solvedPosition.score;
+			searchResult.depth = this->gameBoard.getNumberOfRows() * this->gameBoard.getNumberOfColumns() - this->gameBoard.getNumberOfCoins();
+			searchResult.nodes = 0;
+			searchResult.peakScratchMemory = 0;
+			searchResult.searchStats = SearchStatsCounters().getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+			return true;
+
+		}
+
+		//Play the move the threats on the board force without searching. Returns true and fills in the result if there is
+		//only one move worth playing. A win or loss is scored as one, and any other forced move by its own heuristic score.
+		bool searchForcedMove(SearchResult& searchResult) {
+
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			int numberOfEmptySlots = this->gameBoard.getNumberOfRows() * this->gameBoard.getNumberOfColumns() - this->gameBoard.getNumberOfCoins();
+			ThreatFilterResult threatFilterResult = ThreatFilter::filterMoves(this->gameBoard, false, numberOfEmptySlots);
+			if (numberOfEmptySlots == 0 || !ThreatFilter::isForced(threatFilterResult)) {
+				return false;
 			}
-			else if (coinCount == 2) {
-				hueristicScore = HEURISTIC_SCORE_FOR_TWO_IN_ROW;
+
+			searchResult.searchAlgorithm = SearchAlgorithm::forcedMove;
+			searchResult.bestMove = ThreatFilter::getFirstColumn(threatFilterResult.columns);
+			if (threatFilterResult.outcome == ThreatOutcome::win) {
+				searchResult.score = HeuristicScorer::WINNING_SCORE;
+				searchResult.depth = 1;
 			}
-			else if (coinCount == 3) {
-				hueristicScore = HEURISTIC_SCORE_FOR_THREE_IN_ROW;
+			else if (threatFilterResult.outcome == ThreatOutcome::doubleThreat) {
+				searchResult.score = HeuristicScorer::WINNING_SCORE;
+				searchResult.depth = 3;
 			}
-			else if (coinCount == 4) {
-				hueristicScore = HEURISTIC_SCORE_FOR_FOUR_IN_ROW;
+			else if (threatFilterResult.outcome == ThreatOutcome::loss) {
+				searchResult.score = -1 * HeuristicScorer::WINNING_SCORE;
+				searchResult.depth = 2;
 			}
 			else {
-				hueristicScore = 0;
+				WindowEvaluator windowEvaluator(this->gameBoard, this->heuristicScorer);
+				searchResult.score = windowEvaluator.getMoveHueristicScore(this->gameBoard, searchResult.bestMove, false);
+				searchResult.depth = 1;
 			}
-
+			searchResult.nodes = 0;
+			searchResult.peakScratchMemory = 0;
+			searchResult.searchStats = SearchStatsCounters().getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
 			return true;
+
 		}
 
-		//Heuristic score for dropping a coin in the column played for all potential four-in-a-row horizontal configurations.
-		int getHorizontalHueristicScore(int columnPlayed, model::GameBoard gameBoard, bool isUserCoin) {
+		//Play out random games from the board within the time budget, or for a number of playouts set by the difficulty
+		//level. The node arena of the search is allocated with the first search of the game and reused after that.
+		SearchResult searchWithMonteCarloTreeSearch() {
+
+			if (!this->monteCarloTreeSearch) {
+				this->monteCarloTreeSearch = MonteCarloTreeSearch::create(this->gameBoard.getNumberOfRows(), this->gameBoard.getNumberOfColumns(), this->gameBoard.getWinLength());
+			}
+			this->monteCarloTreeSearch->setPlayoutPolicy(this->playoutPolicy);
+			this->monteCarloTreeSearch->setSearchControl(this->searchControl);
 
-			int slidingWindowStartPosition, hueristicScore, totalHueristicScore = 0, endColumn;
-			if (columnPlayed >= COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW) {
-				slidingWindowStartPosition = columnPlayed - COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
+			if (this->moveTimeBudget > std::chrono::steady_clock::duration::zero()) {
+				return this->monteCarloTreeSearch->searchWithTimeBudget(this->gameBoard, this->moveTimeBudget, false);
 			}
 			else {
-				slidingWindowStartPosition = 0;
+				return this->monteCarloTreeSearch->search(this->gameBoard, this->gameDifficultyLevel * PLAYOUTS_PER_DIFFICULTY_LEVEL, false);
 			}
+		}
 
-			//Consider each four-in-a-row window starting from three before dropped column and ending at the dropped position
-			for (int startColumn = slidingWindowStartPosition; startColumn <= columnPlayed; ++startColumn) {
-
-				if (startColumn + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW > gameBoard.getNumberOfColumns - 1) {
-					break;
-				}
-				else {
-					endColumn = startColumn + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
-				}
+		//Score every computer move with a full width minimax search that maps the columns in parallel at each level. The
+		//move scores of every level are taken from the scratch arena of the thread searching it. Boards that fit into one
+		//word are searched on a board with a one word bitboard, which is much cheaper to copy for each task.
+		SearchResult searchWithMinimax(int depth) {
 
-				int rowContainingDroppedCoin = gameBoard.getRowNumber(getAvailableSlot(columnPlayed));
-				if (isEmptyOrRequiredType(gameBoard.getBoardIndex(rowContainingDroppedCoin, startColumn), gameBoard.getBoardIndex(rowContainingDroppedCoin, endColumn), isUserCoin, hueristicScore, gameBoard)) {
-					totalHueristicScore += hueristicScore;
-				}
+			if (model::SmallGameBoard::fitsPackedPosition(this->gameBoard.getNumberOfRows(), this->gameBoard.getNumberOfColumns())) {
+				return searchWithMinimax(model::SmallGameBoard(this->gameBoard), depth);
+			}
+			else {
+				return searchWithMinimax(this->gameBoard, depth);
 			}
 
-			return totalHueristicScore;
 		}
 
-		//Heuristic score for dropping a coin in the column played for all potential four-in-a-row vertical configurations.
-		int getVerticalHueristicScore(int columnPlayed, model::GameBoard gameBoard, bool isUserCoin) {
+		template <typename GameBoardType>
+		SearchResult searchWithMinimax(const GameBoardType& gameBoard, int depth) {
 
-			int slidingWindowStartPosition, hueristicScore, totalHueristicScore = 0, endRow;
-			int coinDroppedInRow = gameBoard.getRowNumber(getAvailableSlot(columnPlayed));
+			typedef BasicWindowEvaluator<GameBoardType> WindowEvaluatorType;
 
-			if (coinDroppedInRow >= COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW) {
-				slidingWindowStartPosition = coinDroppedInRow - COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			this->minimaxNodeCounts.clear();
+			this->minimaxSearchStats.clear();
+			this->minimaxScratchArena.reset();
+			this->minimaxDepth = depth;
+
+			SearchResult searchResult;
+			searchResult.searchAlgorithm = SearchAlgorithm::minimax;
+			searchResult.depth = depth;
+
+			//The threats on the board settle the position or leave moves out the same way as in the alpha-beta search
+			ThreatFilterResult threatFilterResult = ThreatFilter::filterMoves(gameBoard, false, depth);
+			std::uint32_t allowedColumns = threatFilterResult.columns;
+
+			ScratchArena::Scope scratch(this->minimaxScratchArena);
+			int* moveScores = scratch.allocate<int>(gameBoard.getNumberOfColumns());
+			WindowEvaluatorType windowEvaluator(gameBoard, this->heuristicScorer);
+
+			if (threatFilterResult.outcome != ThreatOutcome::open) {
+				searchResult.bestMove = ThreatFilter::getFirstColumn(threatFilterResult.columns);
+				searchResult.score = threatFilterResult.outcome == ThreatOutcome::loss ? -1 * HeuristicScorer::WINNING_SCORE : HeuristicScorer::WINNING_SCORE;
 			}
 			else {
-				slidingWindowStartPosition = 0;
-			}
-
-			//Consider each four-in-a-row window starting from three before dropped column and ending at the dropped position
-			for (int startRow = slidingWindowStartPosition; startRow <= coinDroppedInRow; ++startRow) {
 
-				if (startRow + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW > gameBoard.getNumberOfRows - 1) {
-					break;
-				}
-				else {
-					endRow = startRow + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
+				//Find best move by considering all columns in parallel using the Map pattern
+				tbb::parallel_for(
+					tbb::blocked_range<int>(0, gameBoard.getNumberOfColumns()),
+					[=, &gameBoard, &windowEvaluator](tbb::blocked_range<int> range) {
+
+					//Each task simulates its moves on its own copy of the board and window counts
+					GameBoardType workerGameBoard = gameBoard;
+					WindowEvaluatorType workerWindowEvaluator = windowEvaluator;
+					for (int columnCounter = range.begin(); columnCounter != range.end(); ++columnCounter) {
+						if (isMinimaxMove(workerGameBoard, columnCounter, allowedColumns)) {
+							moveScores[columnCounter] = getMoveHueristicScore(depth, columnCounter, false, workerGameBoard, workerWindowEvaluator);
+						}
+					}
 				}
-
-				if (isEmptyOrRequiredType(gameBoard.getBoardIndex(startRow, columnPlayed), gameBoard.getBoardIndex(endRow, columnPlayed), isUserCoin, hueristicScore, gameBoard)) {
-					totalHueristicScore += hueristicScore;
+				);
+
+				searchResult.bestMove = -1;
+				searchResult.score = -1 * INT_MAX;
+				for (int moveCounter = 0; moveCounter < gameBoard.getNumberOfColumns(); ++moveCounter) {
+					if (isMinimaxMove(gameBoard, moveCounter, allowedColumns) && (searchResult.bestMove == -1 || moveScores[moveCounter] > searchResult.score)) {
+						searchResult.score = moveScores[moveCounter];
+						searchResult.bestMove = moveCounter;
+					}
 				}
 			}
 
-			return totalHueristicScore;
+			searchResult.nodes = this->minimaxNodeCounts.combine([](std::uint64_t left, std::uint64_t right) { return left + right; });
+			searchResult.peakScratchMemory = this->minimaxScratchArena.getPeakMemory();
+			searchResult.searchStats = this->minimaxSearchStats.getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+			return searchResult;
+
 		}
 
-		int getPositiveSlopeHueristicScore(int columnPlayed, model::GameBoard gameBoard, bool isUserCoin) {
+		//Check if the minimax search scores the move. Moves left out by the threat filter and moves that mirror one further
+		//left are not scored.
+		template <typename GameBoardType>
+		static bool isMinimaxMove(const GameBoardType& gameBoard, int columnNumber, std::uint32_t allowedColumns) {
+			return ThreatFilter::containsColumn(allowedColumns, columnNumber) && gameBoard.canDropCoin(columnNumber) && !gameBoard.isMirrorOfEarlierMove(columnNumber);
+		}
 
-			int slidingWindowStartRowPosition, slidingWindowStartColumnPosition, hueristicScore, totalHueristicScore = 0, endRow, endColumn;
-			int coinDroppedInRow = gameBoard.getRowNumber(getAvailableSlot(columnPlayed));
+		//Compute best heuristic score for opponent move. The board is left as it was found.
+		template <typename GameBoardType>
+		int bestHeuristicScoreForOpponentMove(int depth, bool isUserCoin, GameBoardType& gameBoard, BasicWindowEvaluator<GameBoardType>& windowEvaluator) {
 
-			if (gameBoard.getNumberOfRows() - 1 - coinDroppedInRow >= COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW && columnPlayed >= COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW) {
-				slidingWindowStartRowPosition = coinDroppedInRow + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
-				slidingWindowStartColumnPosition = columnPlayed - COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
+			//Nothing more to look at if maximum depth has been reached or if the board is full
+			if (depth == 0 || gameBoard.isFull()) {
+				this->minimaxSearchStats.countLeaf();
+				return 0;
 			}
-			else {
-				int rowDistanceFromBottom = gameBoard.getNumberOfRows - 1 - coinDroppedInRow;
-				int columnDistanceFromLeft = columnPlayed;
-				
-				slidingWindowStartRowPosition = coinDroppedInRow + std::min(rowDistanceFromBottom, columnDistanceFromLeft);
-				slidingWindowStartColumnPosition = columnPlayed - std::min(rowDistanceFromBottom, columnDistanceFromLeft);
+
+			//Stop right away if the search was cancelled
+			if (this->searchControl != nullptr && this->searchControl->isCancelled()) {
+				return 0;
 			}
 
-			//Consider each four-in-a-row window starting from three before dropped column and ending at the dropped position
-			for (int startRow = slidingWindowStartRowPosition, int startColumn = slidingWindowStartColumnPosition; startColumn <= columnPlayed; --startRow, ++startColumn) {
+			//The threats on the board can settle the position without scoring any move
+			ThreatFilterResult threatFilterResult = ThreatFilter::filterMoves(gameBoard, isUserCoin, depth);
+			if (threatFilterResult.outcome != ThreatOutcome::open) {
+				this->minimaxSearchStats.countLeaf();
+				return threatFilterResult.outcome == ThreatOutcome::loss ? -1 * HeuristicScorer::WINNING_SCORE : HeuristicScorer::WINNING_SCORE;
+			}
+			std::uint32_t allowedColumns = threatFilterResult.columns;
+
+			//Reuse the score if this position or its mirror image has already been scored to the same depth. Scores from
+			//other depths are sums over a different number of moves so they cannot be reused.
+			std::uint64_t positionKey = TranspositionTable::getKey(gameBoard.getCanonicalHash(), isUserCoin);
+			TranspositionTableEntry transpositionTableEntry;
+			bool isTranspositionTableHit = this->transpositionTable.probe(positionKey, transpositionTableEntry);
+			this->minimaxSearchStats.countTranspositionTableProbe(isTranspositionTableHit);
+			if (isTranspositionTableHit && transpositionTableEntry.depth == depth && transpositionTableEntry.scoreBound == ScoreBound::exact) {
+				return transpositionTableEntry.score;
+			}
 
-				if (startColumn + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW > gameBoard.getNumberOfColumns - 1 ||
-					startRow < COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW) {
-					break;
-				}
-				else {
-					endRow = startRow - COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
-					endColumn = startColumn + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
+			ScratchArena::Scope scratch(this->minimaxScratchArena);
+			int* moveScores = scratch.allocate<int>(gameBoard.getNumberOfColumns());
+			//Do a map to find the move with the highest score
+			{
+				SearchStatsCounters::TaskWaitTimer taskWaitTimer(this->minimaxSearchStats);
+				tbb::parallel_for(
+					tbb::blocked_range<int>(0, gameBoard.getNumberOfColumns()),
+					[=, &gameBoard, &windowEvaluator](tbb::blocked_range<int> range) {
+
+					//Each task simulates its moves on its own copy of the board and window counts
+					GameBoardType workerGameBoard = gameBoard;
+					BasicWindowEvaluator<GameBoardType> workerWindowEvaluator = windowEvaluator;
+					for (int columnCounter = range.begin(); columnCounter != range.end(); ++columnCounter) {
+						if (isMinimaxMove(workerGameBoard, columnCounter, allowedColumns)) {
+							moveScores[columnCounter] = getMoveHueristicScore(depth, columnCounter, isUserCoin, workerGameBoard, workerWindowEvaluator);
+						}
+					}
 				}
+				);
+			}
 
-				if (isEmptyOrRequiredType(gameBoard.getBoardIndex(startRow, startColumn), gameBoard.getBoardIndex(endRow, startColumn), isUserCoin, hueristicScore, gameBoard)) {
-					totalHueristicScore += hueristicScore;
+			int bestMove = -1, bestScore = -1 * INT_MAX;
+			for (int moveCounter = 0; moveCounter < gameBoard.getNumberOfColumns(); ++moveCounter) {
+				if (isMinimaxMove(gameBoard, moveCounter, allowedColumns) && (bestMove == -1 || moveScores[moveCounter] > bestScore)) {
+					bestScore = moveScores[moveCounter];
+					bestMove = moveCounter;
 				}
 			}
 
-			return totalHueristicScore;
-		}
+			//The scores of a cancelled search are not reliable
+			if (this->searchControl != nullptr && this->searchControl->isCancelled()) {
+				return bestScore;
+			}
 
-		int getNegativeSlopeHueristicScore(int columnPlayed, model::GameBoard, bool isUserCoin) {
+			this->transpositionTable.store(positionKey, depth, bestScore, ScoreBound::exact, gameBoard.getCanonicalColumn(bestMove));
 
-			int slidingWindowStartRowPosition, slidingWindowStartColumnPosition, hueristicScore, totalHueristicScore = 0, endRow, endColumn;
-			int coinDroppedInRow = gameBoard.getRowNumber(getAvailableSlot(columnPlayed));
+			return bestScore;
 
-			if (coinDroppedInRow >= COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW && columnPlayed >= COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW) {
-				slidingWindowStartRowPosition = coinDroppedInRow - COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
-				slidingWindowStartColumnPosition = columnPlayed - COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
-			}
-			else {
-				int rowDistanceFromTop = coinDroppedInRow;
-				int columnDistanceFromLeft = columnPlayed;
+		}
 
-				slidingWindowStartRowPosition = coinDroppedInRow - std::min(rowDistanceFromTop, columnDistanceFromLeft);
-				slidingWindowStartColumnPosition = columnPlayed - std::min(rowDistanceFromTop, columnDistanceFromLeft);
+		//Compute and return the hueristic score for the move. The coin is dropped on the board for the look ahead and
+		//taken back out before returning.
+		template <typename GameBoardType>
+		int getMoveHueristicScore(int depth, int columnPlayed, bool isUserCoin, GameBoardType& gameBoard, BasicWindowEvaluator<GameBoardType>& windowEvaluator) {
+
+			//If maximum depth has been reached, then return
+			if (depth == 0) {
+				return 0;
 			}
 
-			//Consider each four-in-a-row window starting from three before dropped column and ending at the dropped position
-			for (int startRow = slidingWindowStartRowPosition, int startColumn = slidingWindowStartColumnPosition; startColumn <= columnPlayed; ++startRow, ++startColumn) {
+			++this->minimaxNodeCounts.local();
+			this->minimaxSearchStats.countNode(this->minimaxDepth - depth + 1);
 
-				if (startColumn + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW > gameBoard.getNumberOfColumns - 1 ||
-					startRow + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW < gameBoard.getNumberOfRows() - 1) {
-					break;
-				}
-				else {
-					endRow = startRow + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
-					endColumn = startColumn + COLUMN_OR_ROW_DIFFERENCE_FOR_FOUR_IN_A_ROW;
-				}
+			//Compute hueristic score for horizontal, vertical and diagonal four coins in a row resulting from 
+			//coin being dropped in column
+			int heuristicScoreForCurrentMove = windowEvaluator.getMoveHueristicScore(gameBoard, columnPlayed, isUserCoin);
+			this->minimaxSearchStats.countEvaluation();
 
-				if (isEmptyOrRequiredType(gameBoard.getBoardIndex(startRow, startColumn), gameBoard.getBoardIndex(endRow, startColumn), isUserCoin, hueristicScore, gameBoard)) {
-					totalHueristicScore += hueristicScore;
-				}
+			//If it was a winning move, then return with indicator saying so
+			if (heuristicScoreForCurrentMove == HeuristicScorer::WINNING_SCORE) {
+				this->minimaxSearchStats.countLeaf();
+				return HeuristicScorer::WINNING_SCORE;
 			}
 
-			return totalHueristicScore;
+			//Simulate the dropped coin on the board and undo it once the opponent response has been scored
+			windowEvaluator.dropCoin(gameBoard, columnPlayed, isUserCoin);
+			int bestOpponentScore = bestHeuristicScoreForOpponentMove(depth - 1, isUserCoin ? false : true, gameBoard, windowEvaluator);
+			windowEvaluator.undoCoin(gameBoard, columnPlayed);
+
+			return HeuristicScorer::subtractHeuristicScores(heuristicScoreForCurrentMove, bestOpponentScore);
 		}
 
 	public:
@@ -442,17 +583,56 @@ namespace controller {
 			gameBoard = model::GameBoard();
 			this->firstPlayerIsUser = DEFAULT_FIRST_PLAYER_IS_USER;
 			this->gameDifficultyLevel = DEFAULT_DIFFICULTY_LEVEL;
+			this->transpositionTable.resize(DEFAULT_TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES);
+			this->searchAlgorithm = DEFAULT_SEARCH_ALGORITHM;
+			this->moveOrderingOptions = MoveOrdering().getOptions();
+			this->playoutPolicy = PlayoutPolicy::winsAndBlocks;
+			this->endgameSolverThreshold = DEFAULT_ENDGAME_SOLVER_THRESHOLD;
+			this->moveTimeBudget = std::chrono::steady_clock::duration::zero();
+			this->lastSearchResult = SearchResult();
+			this->searchControl = nullptr;
+			this->ponderingEnabled = false;
+			this->minimaxDepth = 0;
 			//TODO computer to go first depending on user setting
 		}
 
-		ConnectFourGame(int numberOfRows, int numberOfColumns) {
+		ConnectFourGame(int numberOfRows, int numberOfColumns) : ConnectFourGame(numberOfRows, numberOfColumns, model::GameBoard::DEFAULT_WIN_LENGTH) {
+		}
+
+		//Game played to the given number of coins in a row, such as five in a row on a board of 15 by 15
+		ConnectFourGame(int numberOfRows, int numberOfColumns, int winLength) : ConnectFourGame(numberOfRows, numberOfColumns, winLength, DEFAULT_TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES) {
+		}
+
+		//Game with a transposition table of the given size, allocated once. Hosts of many games at once want far smaller
+		//tables than the default.
+		ConnectFourGame(int numberOfRows, int numberOfColumns, int winLength, std::size_t transpositionTableSizeInMegabytes) {
 
-			gameBoard = model::GameBoard(numberOfRows, numberOfColumns);
+			gameBoard = model::GameBoard(numberOfRows, numberOfColumns, winLength);
 			this->firstPlayerIsUser = DEFAULT_FIRST_PLAYER_IS_USER;
 			this->gameDifficultyLevel = DEFAULT_DIFFICULTY_LEVEL;
+			this->transpositionTable.resize(transpositionTableSizeInMegabytes);
+			this->searchAlgorithm = DEFAULT_SEARCH_ALGORITHM;
+			this->moveOrderingOptions = MoveOrdering().getOptions();
+			this->playoutPolicy = PlayoutPolicy::winsAndBlocks;
+			this->endgameSolverThreshold = DEFAULT_ENDGAME_SOLVER_THRESHOLD;
+			this->moveTimeBudget = std::chrono::steady_clock::duration::zero();
+			this->lastSearchResult = SearchResult();
+			this->searchControl = nullptr;
+			this->ponderingEnabled = false;
+			this->minimaxDepth = 0;
 			//TODO computer to go first depending on user setting
 		}
 
+		//Stop any computer move still being computed before the game goes away
+		~ConnectFourGame() {
+
+			if (this->computerMove) {
+				this->computerMove->cancel();
+				this->computerMove->waitUntilFinished();
+			}
+			stopPondering();
+		}
+
 		//First player will be determined by user selection
 		void setWhoPlaysFirst(bool firstPlayerIsUser) {
 			this->firstPlayerIsUser = firstPlayerIsUser;
@@ -460,15 +640,248 @@ namespace controller {
 
 		//Difficulty level will be set by user
 		void setgameDifficultyLevel(int gameDifficultyLevel) {
+			stopSearchesForChange("difficulty level");
 			this->gameDifficultyLevel = gameDifficultyLevel;
 		}
 
+		//Size of the table of scored positions shared by the search threads. A size of zero turns it off.
+		void setTranspositionTableSize(std::size_t sizeInMegabytes) {
+			stopSearchesForChange("transposition table size");
+			this->transpositionTable.resize(sizeInMegabytes);
+		}
+
+		//Hit, collision and overwrite counts of the table of scored positions. The counts are kept by each search thread
+		//and only added up here, so they cannot be read while the computer move is being computed. Pondering is stopped.
+		TranspositionTableStatistics getTranspositionTableStatistics() {
+			if (isComputerMoveInProgress()) {
+				throw std::logic_error("Cannot read the transposition table statistics while the computer move is still being computed.");
+			}
+			stopPondering();
+			return this->transpositionTable.getStatistics();
+		}
+
+		//Give the alpha-beta or Monte Carlo tree search a time budget for each move instead of the depth or number of
+		//playouts set by the difficulty level. The depth reached is reported in the search result. A budget of zero goes
+		//back to the difficulty level.
+		void setMoveTimeBudget(std::chrono::steady_clock::duration moveTimeBudget) {
+			stopSearchesForChange("move time budget");
+			this->moveTimeBudget = moveTimeBudget;
+		}
+
+		//Search used to pick the computer move
+		void setSearchAlgorithm(SearchAlgorithm searchAlgorithm) {
+			stopSearchesForChange("search algorithm");
+			this->searchAlgorithm = searchAlgorithm;
+		}
+
+		//Play the computer moves found in the opening book file before searching. The file is mapped once and shared by
+		//every game that uses it. An empty path stops using the book.
+		void setOpeningBook(const std::string& openingBookPath) {
+
+			stopSearchesForChange("opening book");
+			if (openingBookPath.empty()) {
+				this->openingBook.reset();
+			}
+			else {
+				this->openingBook = OpeningBook::open(openingBookPath);
+			}
+		}
+
+		//Save the positions the endgame solver proves to the file and play the computer move from it when the position
+		//was solved before, by this game or by any other game or process using the file. A missing file is created. The
+		//file is mapped once and shared by every game in the process that uses it. An empty path stops using the file.
+		void setSolvedPositionStore(const std::string& solvedPositionStorePath) {
+
+			stopSearchesForChange("solved position store");
+			if (solvedPositionStorePath.empty()) {
+				this->solvedPositionStore.reset();
+			}
+			else {
+				this->solvedPositionStore = SolvedPositionStore::open(solvedPositionStorePath, this->gameBoard.getNumberOfRows(), this->gameBoard.getNumberOfColumns());
+			}
+		}
+
+		//Solve the game exactly instead of searching it once no more than this many slots are empty. A threshold below
+		//zero never switches to the solver.
+		void setEndgameSolverThreshold(int endgameSolverThreshold) {
+			stopSearchesForChange("endgame solver threshold");
+			this->endgameSolverThreshold = endgameSolverThreshold;
+		}
+
+		//Keep searching in the background on the likely user moves after the computer has moved, so that the reply to the
+		//move the user makes is often already in the transposition table. Pondering keeps the cores busy while the user
+		//thinks, and any user move cancels it.
+		void setPondering(bool ponderingEnabled) {
+			stopSearchesForChange("pondering");
+			this->ponderingEnabled = ponderingEnabled;
+		}
+
+		//How the Monte Carlo tree search plays its games out
+		void setPlayoutPolicy(PlayoutPolicy playoutPolicy) {
+			stopSearchesForChange("playout policy");
+			this->playoutPolicy = playoutPolicy;
+		}
+
+		//Most scratch memory each thread of the minimax search can take. A search that needs more throws.
+		void setScratchMemoryLimit(std::size_t bytesPerThread) {
+			stopSearchesForChange("scratch memory limit");
+			this->minimaxScratchArena.setCapacity(bytesPerThread);
+		}
+
+		//Scores of the windows the minimax and alpha-beta searches add up. The transposition table is cleared, since the
+		//positions in it were scored with the old weights. Moves from the opening book were searched with the weights
+		//the book was built with.
+		void setHeuristicWeights(const HeuristicWeights& heuristicWeights) {
+
+			stopSearchesForChange("heuristic weights");
+			this->heuristicScorer = HeuristicScorer(heuristicWeights);
+			this->transpositionTable.clear();
+		}
+
+		HeuristicWeights getHeuristicWeights() {
+			return this->heuristicScorer.getWeights();
+		}
+
+		//Switch stages of the alpha-beta move ordering on or off to measure how much each one cuts the node count
+		void setMoveOrderingOptions(MoveOrderingOptions moveOrderingOptions) {
+			stopSearchesForChange("move ordering options");
+			this->moveOrderingOptions = moveOrderingOptions;
+		}
+
+		MoveOrderingOptions getMoveOrderingOptions() {
+			return this->moveOrderingOptions;
+		}
+
+		//Find the best computer move for the current board with the given search without playing it. The result carries
+		//the node count and time taken so that the searches can be compared.
+		SearchResult searchComputerMove(SearchAlgorithm searchAlgorithm) {
+
+			SearchResult searchResult;
+			if (searchAlgorithm == SearchAlgorithm::minimax) {
+				return searchWithMinimax(this->gameDifficultyLevel);
+			}
+			else if (searchAlgorithm == SearchAlgorithm::openingBook && searchOpeningBook(searchResult)) {
+				return searchResult;
+			}
+			else if (searchAlgorithm == SearchAlgorithm::endgameSolver) {
+				std::unique_ptr<EndgameSolver> endgameSolver = EndgameSolver::create(this->gameBoard.getNumberOfRows(), this->gameBoard.getNumberOfColumns(), this->gameBoard.getWinLength(), this->transpositionTable);
+				endgameSolver->setSearchControl(this->searchControl);
+				endgameSolver->setSolvedPositionStore(this->solvedPositionStore.get());
+				return endgameSolver->solve(this->gameBoard, false);
+			}
+			else if (searchAlgorithm == SearchAlgorithm::monteCarloTreeSearch) {
+				return searchWithMonteCarloTreeSearch();
+			}
+			else if (this->moveTimeBudget > std::chrono::steady_clock::duration::zero()) {
+				std::unique_ptr<AlphaBetaSearch> alphaBetaSearch = AlphaBetaSearch::create(this->gameBoard.getNumberOfRows(), this->gameBoard.getNumberOfColumns(), this->gameBoard.getWinLength(), this->heuristicScorer, this->transpositionTable);
+				alphaBetaSearch->setMoveOrderingOptions(this->moveOrderingOptions);
+				alphaBetaSearch->setSearchControl(this->searchControl);
+				return alphaBetaSearch->searchWithTimeBudget(this->gameBoard, this->moveTimeBudget, false);
+			}
+			else {
+				std::unique_ptr<AlphaBetaSearch> alphaBetaSearch = AlphaBetaSearch::create(this->gameBoard.getNumberOfRows(), this->gameBoard.getNumberOfColumns(), this->gameBoard.getWinLength(), this->heuristicScorer, this->transpositionTable);
+				alphaBetaSearch->setMoveOrderingOptions(this->moveOrderingOptions);
+				alphaBetaSearch->setSearchControl(this->searchControl);
+				return alphaBetaSearch->search(this->gameBoard, this->gameDifficultyLevel, false);
+			}
+		}
+
+		//Result of the search for the last computer move
+		SearchResult getLastSearchResult() {
+			return this->lastSearchResult;
+		}
+
+		//Number of coins played so far by both players
+		int getNumberOfCoins() {
+			return this->gameBoard.getNumberOfCoins();
+		}
+
+		//Continue the game from the given board, for example to search a stored position
+		void setGameBoard(const model::GameBoard& gameBoard) {
+
+			if (isComputerMoveInProgress()) {
+				throw std::logic_error("Cannot change the board while the computer move is still being computed.");
+			}
+
+			stopPondering();
+			if (gameBoard.getNumberOfRows() != this->gameBoard.getNumberOfRows() || gameBoard.getNumberOfColumns() != this->gameBoard.getNumberOfColumns() ||
+				gameBoard.getWinLength() != this->gameBoard.getWinLength()) {
+				this->monteCarloTreeSearch.reset();
+			}
+			this->gameBoard = gameBoard;
+		}
+
 		//User method to drop a coin into one of the columns
 		void dropCoin(int dropInColumn) {
 
+			if (isComputerMoveInProgress()) {
+				throw std::logic_error("Cannot drop a coin while the computer move is still being computed.");
+			}
+
+			stopPondering();
 			dropCoin(dropInColumn, true);
 		}
 
+		//Play the computer move on the current board, for example when the computer goes first or the game goes on from a
+		//stored position with the computer to move. Returns the column played, or -1 if the board is already full.
+		int playComputerMoveNow() {
+
+			if (isComputerMoveInProgress()) {
+				throw std::logic_error("Cannot play the computer move while another one is still being computed.");
+			}
+
+			stopPondering();
+			if (this->gameBoard.isFull()) {
+				return -1;
+			}
+
+			playComputerMove();
+			return this->lastSearchResult.bestMove;
+		}
+
+		//Drop a user coin and compute the computer reply in the background. The returned handle can be polled for the
+		//best move so far, waited on or cancelled, and the callback, if given, is called once the computer has moved.
+		//The board must not be played on until the handle is done, and the settings the search reads cannot be changed
+		//until then either: their setters throw while the computer move is being computed. The result has no best move if
+		//the user move was not valid or ended the game.
+		std::shared_ptr<ComputerMoveHandle> dropCoinAsync(int dropInColumn, std::function<void(const SearchResult&)> onComplete = nullptr) {
+
+			if (isComputerMoveInProgress()) {
+				throw std::logic_error("Cannot drop a coin while the computer move is still being computed.");
+			}
+
+			stopPondering();
+			std::shared_ptr<ComputerMoveHandle> computerMove(new ComputerMoveHandle(onComplete));
+			this->computerMove = computerMove;
+
+			if (!playUserCoin(dropInColumn, true)) {
+				SearchResult noSearchResult = SearchResult();
+				noSearchResult.searchAlgorithm = this->searchAlgorithm;
+				noSearchResult.bestMove = -1;
+				computerMove->complete(noSearchResult);
+				return computerMove;
+			}
+
+			//The search runs in the arena of the game, and its tasks check the handle for cancellation at every node
+			this->computerMoveArena.enqueue([this, computerMove]() {
+
+				try {
+					this->searchControl = &computerMove->getSearchControl();
+					playComputerMove();
+					this->searchControl = nullptr;
+				}
+				catch (...) {
+					this->searchControl = nullptr;
+					computerMove->fail(std::current_exception());
+					return;
+				}
+
+				computerMove->complete(this->lastSearchResult);
+			});
+
+			return computerMove;
+		}
+
 	};
 
 }
\ No newline at end of file
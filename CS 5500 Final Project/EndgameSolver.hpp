@@ -0,0 +1,383 @@
+#pragma once
+
+#include <tbb\spin_mutex.h>
+#include <tbb\task_group.h>
+
+#include "GameBoard.hpp"
+#include "SearchControl.hpp"
+#include "SearchResult.hpp"
+#include "SearchStats.hpp"
+#include "SolvedPositionStore.hpp"
+#include "ThreatFilter.hpp"
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+namespace controller {
+
+	//Exact solver for the end of the game. The score of a position counts the empty slots left when the game ends, so a
+	//faster win scores more and a slower loss scores less:
+	//   a win with k slots still empty after the winning coin scores k + 1
+	//   a draw scores 0
+	//   a loss is the negative of the win of the opponent
+	//Solvers are made by create, which picks a solver compiled for the size of the board when there is one.
+	class EndgameSolver {
+
+	public:
+
+		//Depth saved with solved positions in the transposition table. Depth limited searches never reach it, so their
+		//entries and the entries of the solver can share the table without being mistaken for each other.
+		const static int SOLVED_DEPTH = TranspositionTable::MAXIMUM_DEPTH;
+
+		virtual ~EndgameSolver() {
+		}
+
+		//Find the move with the best exact score for the player to move. The depth of the result is the number of empty
+		//slots, which is how far the solver looked ahead.
+		virtual SearchResult solve(const model::GameBoard& gameBoard, bool isUserCoin) = 0;
+
+		//Let the solves that follow be cancelled through the control. Null solves without one.
+		virtual void setSearchControl(SearchControl* searchControl) = 0;
+
+		//Look positions up in the store before solving them and save the ones that are solved. Null solves without one.
+		virtual void setSolvedPositionStore(SolvedPositionStore* solvedPositionStore) = 0;
+
+		//Solver on the board type that suits the board, see model::createForBoardType
+		static std::unique_ptr<EndgameSolver> create(int numberOfRows, int numberOfColumns, int winLength, TranspositionTable& transpositionTable);
+
+	};
+
+	//Negamax proof search with alpha-beta pruning. Before any move is searched the solver plays an immediate win, blocks
+	//the only immediate win of the opponent, or gives up if the opponent has two of them, and it never plays under a slot
+	//the opponent would win at. The score window is then narrowed to the scores the position can still reach. As in the
+	//alpha-beta search, the eldest child is searched first and the younger siblings are searched in parallel near the
+	//root, each task on its own copy of the board. The solved position store, if there is one, is only used for the root
+	//and for positions far enough from the end that solving them again would take long, which keeps the number of
+	//writes to the shared file down.
+	template <typename GameBoardType>
+	class BasicEndgameSolver : public EndgameSolver {
+
+	private:
+
+		//Constants
+		const static int MINIMUM_EMPTY_SLOTS_FOR_PARALLEL_SIBLINGS = 12;
+		const static int MINIMUM_EMPTY_SLOTS_FOR_SOLVED_POSITION_STORE = 14;
+
+		//Members
+		TranspositionTable& transpositionTable;
+		SearchControl* searchControl;
+		SolvedPositionStore* solvedPositionStore;
+		SearchStatsCounters searchStatsCounters;
+		int rootNumberOfCoins;
+		std::atomic<std::uint64_t> nodeCount;
+		int centerOutColumns[GameBoardType::MAXIMUM_NUMBER_OF_COLUMNS];
+
+		//Check if the score being worked out is going to be thrown away, either because the solve was cancelled or
+		//because a sibling of an ancestor has cut this subtree off
+		bool isSolveAborted() const {
+
+			return (this->searchControl != nullptr && this->searchControl->isCancelled()) || tbb::is_current_task_group_canceling();
+
+		}
+
+		//List the columns from the center outwards, the left one first when two are as close to the center
+		void setCenterOutColumns(int numberOfColumns) {
+
+			int numberOfListedColumns = 0;
+			for (int centerDistance = 0; centerDistance < numberOfColumns; ++centerDistance) {
+				for (int columnCounter = 0; columnCounter < numberOfColumns; ++columnCounter) {
+					if (std::abs(2 * columnCounter - (numberOfColumns - 1)) == centerDistance) {
+						this->centerOutColumns[numberOfListedColumns++] = columnCounter;
+					}
+				}
+			}
+		}
+
+		//Check if the move is one of the allowed columns and can be played. On a board that is its own mirror image the
+		//moves on the right half score the same as the ones on the left and are left out.
+		static bool isAllowedMove(const GameBoardType& gameBoard, int columnNumber, std::uint32_t allowedColumns) {
+
+			return ThreatFilter::containsColumn(allowedColumns, columnNumber) && gameBoard.canDropCoin(columnNumber) && !gameBoard.isMirrorOfEarlierMove(columnNumber);
+		}
+
+		//Try the saved best move first, then the columns closest to the center. Only the allowed columns are listed.
+		int orderMoves(const GameBoardType& gameBoard, int transpositionTableMove, std::uint32_t allowedColumns, int* moves) const {
+
+			int numberOfMoves = 0;
+			if (transpositionTableMove >= 0 && isAllowedMove(gameBoard, transpositionTableMove, allowedColumns)) {
+				moves[numberOfMoves++] = transpositionTableMove;
+			}
+
+			for (int columnCounter = 0; columnCounter < gameBoard.getNumberOfColumns(); ++columnCounter) {
+				int columnNumber = this->centerOutColumns[columnCounter];
+				if (columnNumber != transpositionTableMove && isAllowedMove(gameBoard, columnNumber, allowedColumns)) {
+					moves[numberOfMoves++] = columnNumber;
+				}
+			}
+
+			return numberOfMoves;
+		}
+
+		//Score a move by dropping the coin and solving the opponent replies
+		int solveMove(GameBoardType& gameBoard, int columnPlayed, int alpha, int beta, bool isUserCoin, std::uint64_t& nodes) {
+
+			int opponentBestMove;
+			gameBoard.dropCoinUnchecked(columnPlayed, isUserCoin);
+			int score = -1 * negamax(gameBoard, -1 * beta, -1 * alpha, isUserCoin ? false : true, nodes, opponentBestMove);
+			gameBoard.undoCoinUnchecked(columnPlayed);
+			return score;
+		}
+
+		//Search the younger siblings in parallel once the eldest has been solved, with a null window around the best
+		//score found so far
+		void solveYoungerBrothers(const GameBoardType& gameBoard, const int* moves, int numberOfMoves, int& alpha, int beta, bool isUserCoin, int& bestScore, int& bestMove) {
+
+			std::atomic<int> sharedAlpha(alpha);
+			tbb::spin_mutex bestScoreMutex;
+			tbb::task_group youngerBrothers;
+
+			for (int moveCounter = 1; moveCounter < numberOfMoves; ++moveCounter) {
+
+				int columnPlayed = moves[moveCounter];
+				youngerBrothers.run([&, columnPlayed]() {
+
+					GameBoardType brotherGameBoard = gameBoard;
+					std::uint64_t brotherNodes = 0;
+
+					int brotherAlpha = sharedAlpha.load();
+					int score = solveMove(brotherGameBoard, columnPlayed, brotherAlpha, brotherAlpha + 1, isUserCoin, brotherNodes);
+					if (score > brotherAlpha && score < beta) {
+						score = solveMove(brotherGameBoard, columnPlayed, brotherAlpha, beta, isUserCoin, brotherNodes);
+					}
+
+					this->nodeCount.fetch_add(brotherNodes, std::memory_order_relaxed);
+
+					//The score of a cancelled search is not reliable
+					if (isSolveAborted()) {
+						return;
+					}
+
+					tbb::spin_mutex::scoped_lock lock(bestScoreMutex);
+					if (score > bestScore) {
+						bestScore = score;
+						bestMove = columnPlayed;
+					}
+					if (score > sharedAlpha.load()) {
+						sharedAlpha.store(score);
+					}
+					if (score >= beta) {
+						youngerBrothers.cancel();
+					}
+				});
+			}
+
+			{
+				SearchStatsCounters::TaskWaitTimer taskWaitTimer(this->searchStatsCounters);
+				youngerBrothers.wait();
+			}
+			alpha = sharedAlpha.load();
+		}
+
+		//Exact score of the position for the player to move, or a bound on it if it falls outside the window. Nobody has
+		//won yet. The board is left as it was found.
+		int negamax(GameBoardType& gameBoard, int alpha, int beta, bool isUserCoin, std::uint64_t& nodes, int& bestMove) {
+
+			++nodes;
+			this->searchStatsCounters.countNode(gameBoard.getNumberOfCoins() - this->rootNumberOfCoins);
+			bestMove = -1;
+
+			int numberOfEmptySlots = gameBoard.getNumberOfRows() * gameBoard.getNumberOfColumns() - gameBoard.getNumberOfCoins();
+			if (numberOfEmptySlots == 0) {
+				this->searchStatsCounters.countLeaf();
+				return 0;
+			}
+
+			//Stop right away if the solve was cancelled or a sibling of an ancestor has already cut this subtree off
+			if (isSolveAborted()) {
+				return 0;
+			}
+
+			//Win now if possible, lose on the next opponent move if every move gives the opponent a win, and win on the
+			//next move with two threats the opponent cannot both block. Otherwise only the moves the threat filter leaves
+			//are searched: the block of an opponent win, or the moves that do not hand the opponent a win.
+			ThreatFilterResult threatFilterResult = ThreatFilter::filterMoves(gameBoard, isUserCoin, numberOfEmptySlots);
+			if (threatFilterResult.outcome != ThreatOutcome::open) {
+				bestMove = ThreatFilter::getFirstColumn(threatFilterResult.columns);
+				this->searchStatsCounters.countLeaf();
+				if (threatFilterResult.outcome == ThreatOutcome::win) {
+					return numberOfEmptySlots;
+				}
+				else if (threatFilterResult.outcome == ThreatOutcome::doubleThreat) {
+					return numberOfEmptySlots - 2;
+				}
+				else {
+					return -1 * (numberOfEmptySlots - 1);
+				}
+			}
+
+			//Nothing can win on this move, so the best is a win on the next move of the player and the worst a loss on the
+			//next move of the opponent
+			int highestScore = std::max(numberOfEmptySlots - 2, 0);
+			int lowestScore = -1 * (numberOfEmptySlots - 1);
+			beta = std::min(beta, highestScore);
+			alpha = std::max(alpha, lowestScore);
+			if (alpha >= beta) {
+				return alpha;
+			}
+
+			//A position solved before, maybe by another process, needs no solving
+			bool usesSolvedPositionStore = this->solvedPositionStore != nullptr && numberOfEmptySlots >= MINIMUM_EMPTY_SLOTS_FOR_SOLVED_POSITION_STORE;
+			SolvedPosition solvedPosition;
+			if (usesSolvedPositionStore && this->solvedPositionStore->lookUp(gameBoard, isUserCoin, solvedPosition)) {
+				bestMove = solvedPosition.bestMove;
+				return solvedPosition.score;
+			}
+
+			//A solved bound of the position or its mirror image narrows the window further
+			std::uint64_t positionKey = TranspositionTable::getKey(gameBoard.getCanonicalHash(), isUserCoin);
+			TranspositionTableEntry transpositionTableEntry;
+			int transpositionTableMove = -1;
+			bool isTranspositionTableHit = this->transpositionTable.probe(positionKey, transpositionTableEntry);
+			this->searchStatsCounters.countTranspositionTableProbe(isTranspositionTableHit);
+			if (isTranspositionTableHit) {
+
+				if (transpositionTableEntry.depth == SOLVED_DEPTH) {
+					if (transpositionTableEntry.scoreBound == ScoreBound::exact) {
+						bestMove = gameBoard.getCanonicalColumn(transpositionTableEntry.bestMove);
+						return transpositionTableEntry.score;
+					}
+					else if (transpositionTableEntry.scoreBound == ScoreBound::lowerBound) {
+						alpha = std::max(alpha, transpositionTableEntry.score);
+					}
+					else {
+						beta = std::min(beta, transpositionTableEntry.score);
+					}
+					if (alpha >= beta) {
+						bestMove = gameBoard.getCanonicalColumn(transpositionTableEntry.bestMove);
+						return transpositionTableEntry.score;
+					}
+				}
+
+				transpositionTableMove = gameBoard.getCanonicalColumn(transpositionTableEntry.bestMove);
+			}
+
+			int alphaOriginal = alpha;
+
+			int moves[GameBoardType::MAXIMUM_NUMBER_OF_COLUMNS] = {};
+			int numberOfMoves = orderMoves(gameBoard, transpositionTableMove, threatFilterResult.columns, moves);
+
+			//Solve the eldest brother on its own
+			int bestScore = solveMove(gameBoard, moves[0], alpha, beta, isUserCoin, nodes);
+			bestMove = moves[0];
+			alpha = std::max(alpha, bestScore);
+
+			if (alpha < beta && numberOfMoves > 1) {
+
+				if (numberOfEmptySlots >= MINIMUM_EMPTY_SLOTS_FOR_PARALLEL_SIBLINGS) {
+					solveYoungerBrothers(gameBoard, moves, numberOfMoves, alpha, beta, isUserCoin, bestScore, bestMove);
+				}
+				else {
+					for (int moveCounter = 1; moveCounter < numberOfMoves && alpha < beta; ++moveCounter) {
+
+						int score = solveMove(gameBoard, moves[moveCounter], alpha, alpha + 1, isUserCoin, nodes);
+						if (score > alpha && score < beta) {
+							score = solveMove(gameBoard, moves[moveCounter], alpha, beta, isUserCoin, nodes);
+						}
+
+						if (score > bestScore) {
+							bestScore = score;
+							bestMove = moves[moveCounter];
+						}
+						alpha = std::max(alpha, score);
+					}
+				}
+			}
+
+			//Do not save scores from a subtree that was cancelled part way through
+			if (isSolveAborted()) {
+				return bestScore;
+			}
+
+			ScoreBound scoreBound = ScoreBound::exact;
+			if (bestScore <= alphaOriginal) {
+				scoreBound = ScoreBound::upperBound;
+			}
+			else if (bestScore >= beta) {
+				scoreBound = ScoreBound::lowerBound;
+				this->searchStatsCounters.countCutoff();
+			}
+			this->transpositionTable.store(positionKey, SOLVED_DEPTH, bestScore, scoreBound, gameBoard.getCanonicalColumn(bestMove));
+			if (usesSolvedPositionStore && scoreBound == ScoreBound::exact) {
+				this->solvedPositionStore->store(gameBoard, isUserCoin, bestScore, bestMove);
+			}
+
+			return bestScore;
+		}
+
+	public:
+
+		explicit BasicEndgameSolver(TranspositionTable& transpositionTable) : transpositionTable(transpositionTable), searchControl(nullptr), solvedPositionStore(nullptr), rootNumberOfCoins(0), nodeCount(0) {
+		}
+
+		void setSearchControl(SearchControl* searchControl) override {
+
+			this->searchControl = searchControl;
+		}
+
+		void setSolvedPositionStore(SolvedPositionStore* solvedPositionStore) override {
+
+			this->solvedPositionStore = solvedPositionStore;
+		}
+
+		SearchResult solve(const model::GameBoard& gameBoard, bool isUserCoin) override {
+
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			this->nodeCount.store(0);
+			this->searchStatsCounters.clear();
+
+			GameBoardType solveGameBoard(gameBoard);
+			this->rootNumberOfCoins = solveGameBoard.getNumberOfCoins();
+			setCenterOutColumns(solveGameBoard.getNumberOfColumns());
+			int numberOfEmptySlots = solveGameBoard.getNumberOfRows() * solveGameBoard.getNumberOfColumns() - solveGameBoard.getNumberOfCoins();
+
+			SearchResult searchResult;
+			searchResult.searchAlgorithm = SearchAlgorithm::endgameSolver;
+			searchResult.depth = numberOfEmptySlots;
+
+			//The root is solved with the whole window, so its score is exact however close to the end it is
+			std::uint64_t nodes = 0;
+			SolvedPosition solvedPosition;
+			if (this->solvedPositionStore != nullptr && this->solvedPositionStore->lookUp(solveGameBoard, isUserCoin, solvedPosition)) {
+				searchResult.score = solvedPosition.score;
+				searchResult.bestMove = solvedPosition.bestMove;
+			}
+			else {
+				searchResult.score = negamax(solveGameBoard, -1 * numberOfEmptySlots, numberOfEmptySlots, isUserCoin, nodes, searchResult.bestMove);
+				if (this->solvedPositionStore != nullptr && !isSolveAborted()) {
+					this->solvedPositionStore->store(solveGameBoard, isUserCoin, searchResult.score, searchResult.bestMove);
+				}
+			}
+			if (this->searchControl != nullptr && !this->searchControl->isCancelled()) {
+				this->searchControl->reportProgress(searchResult.bestMove, searchResult.depth);
+			}
+
+			searchResult.nodes = this->nodeCount.fetch_add(nodes) + nodes;
+			searchResult.peakScratchMemory = 0;
+			searchResult.searchStats = this->searchStatsCounters.getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+			return searchResult;
+		}
+
+	};
+
+	inline std::unique_ptr<EndgameSolver> EndgameSolver::create(int numberOfRows, int numberOfColumns, int winLength, TranspositionTable& transpositionTable) {
+
+		return model::createForBoardType<EndgameSolver, BasicEndgameSolver>(numberOfRows, numberOfColumns, winLength, transpositionTable);
+	}
+
+}
@@ -1,63 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
 #include <sstream>
+#include <utility>
 #include <vector>
 
+#include "Bitboard.hpp"
 #include "GameSlot.hpp"
+#include "WindowTable.hpp"
 
 namespace model {
 
-	class GameBoard {
+	//Game board stored as bitboards. Each column takes numberOfRows + 1 bits starting from the bottom row, the extra bit
+	//on top of every column is always clear so that checks for coins in a row can be done by shifting without wrapping
+	//into the next column. Board indexes used by the public methods still count row by row from the top left cell.
+	//The number of rows and columns can be fixed when the board type is compiled. The board geometry, loop bounds and
+	//window table then become constants. Dimensions left at zero are set when the board is made, along with the number
+	//of coins in a row that wins, so the same board plays Connect Four or five in a row on a board of 15 by 15. Boards
+	//of fixed size always play Connect Four. The bitboard has as many words as the board needs: as many as the slots of
+	//a board of fixed size take, and by default eight for boards sized at run time, which is enough for a board of 20 by
+	//20.
+	template <int FIXED_NUMBER_OF_ROWS = 0, int FIXED_NUMBER_OF_COLUMNS = 0,
+		int NUMBER_OF_WORDS = (FIXED_NUMBER_OF_ROWS > 0 ? ((FIXED_NUMBER_OF_ROWS + 1) * FIXED_NUMBER_OF_COLUMNS + 63) / 64 : 8)>
+	class BasicGameBoard {
+
+		template <int, int, int> friend class BasicGameBoard;
+
+	public:
+
+		//Bitboard of the coins of one player
+		typedef BasicBitboard<NUMBER_OF_WORDS> Bitboard;
+
+		//Largest number of columns a board can have
+		const static int MAXIMUM_NUMBER_OF_COLUMNS = 20;
+
+		//Largest number of rows a board can have. The bits of a column are read as one word.
+		const static int MAXIMUM_NUMBER_OF_ROWS = Bitboard::BITS_IN_WORD - 1;
+
+		//Largest number of slots a board can have. Every slot takes a bit of the bitboard.
+		const static int MAXIMUM_NUMBER_OF_SLOTS = Bitboard::NUMBER_OF_BITS;
+
+		//Number of coins in a row that wins unless the board says otherwise
+		const static int DEFAULT_WIN_LENGTH = 4;
+
+		//Most coins in a row a board can be played to
+		const static int MAXIMUM_WIN_LENGTH = 8;
+
+		//Check if the dimensions of the board are part of its type
+		const static bool HAS_FIXED_SIZE = FIXED_NUMBER_OF_ROWS > 0 && FIXED_NUMBER_OF_COLUMNS > 0;
+
+		//Window table used by boards of this type
+		typedef BasicWindowTable<FIXED_NUMBER_OF_ROWS, FIXED_NUMBER_OF_COLUMNS> WindowTableType;
+
+		//Most windows a board of this type can have. A slot starts at most one window in each of the four directions.
+		const static int MAXIMUM_NUMBER_OF_WINDOWS = HAS_FIXED_SIZE ? WindowTableLayout::getNumberOfWindows(FIXED_NUMBER_OF_ROWS, FIXED_NUMBER_OF_COLUMNS, DEFAULT_WIN_LENGTH) :
+			WindowTableLayout::NUMBER_OF_DIRECTIONS * MAXIMUM_NUMBER_OF_SLOTS;
 
 	private:
 
+		//Constants for default values and limits
+		const static int DEFAULT_NUMBER_OF_ROWS = HAS_FIXED_SIZE ? FIXED_NUMBER_OF_ROWS : 6;
+		const static int DEFAULT_NUMBER_OF_COLUMNS = HAS_FIXED_SIZE ? FIXED_NUMBER_OF_COLUMNS : 7;
+		const static int NUMBER_OF_BITS_IN_PACKED_POSITION = 64;
+
+		static_assert(FIXED_NUMBER_OF_ROWS >= 0 && FIXED_NUMBER_OF_COLUMNS >= 0 && (FIXED_NUMBER_OF_ROWS > 0) == (FIXED_NUMBER_OF_COLUMNS > 0),
+			"Either both dimensions of the board are fixed or neither is.");
+		static_assert(FIXED_NUMBER_OF_COLUMNS <= MAXIMUM_NUMBER_OF_COLUMNS && FIXED_NUMBER_OF_ROWS <= MAXIMUM_NUMBER_OF_ROWS &&
+			(FIXED_NUMBER_OF_ROWS + 1) * FIXED_NUMBER_OF_COLUMNS <= Bitboard::NUMBER_OF_BITS,
+			"The board does not fit into the bitboard.");
+
 		//Members
-		std::vector<GameSlot> gameBoard;
-		int numberOfRows, numberOfColumns;
+		Bitboard userCoins, computerCoins, bottomBits, boardBits;
+		std::uint64_t zobristHash, mirroredZobristHash;
+		const WindowTableType* windowTable;
+		std::uint8_t columnHeights[MAXIMUM_NUMBER_OF_COLUMNS];
+		std::uint16_t numberOfCoins;
+		std::uint8_t numberOfRows, numberOfColumns, winLength;
 		bool forceDropAllowed;
 
-		//Constants for default values
-		const static int DEFAULT_NUMBER_OF_ROWS = 6;
-		const static int DEFAULT_NUMBER_OF_COLUMNS = 7;
+		//Set up an empty board after making sure the dimensions fit into the bitboard
+		void initialize(int numberOfRows, int numberOfColumns, int winLength, bool forceDropAllowed) {
+
+			if (numberOfRows < 1 || numberOfColumns < 1 || numberOfColumns > MAXIMUM_NUMBER_OF_COLUMNS || numberOfRows > MAXIMUM_NUMBER_OF_ROWS ||
+				(numberOfRows + 1) * numberOfColumns > Bitboard::NUMBER_OF_BITS) {
+				std::stringstream errorMessage;
+				errorMessage << "A board with " << numberOfRows << " rows and " << numberOfColumns << " columns does not fit into the bitboard.";
+				throw std::logic_error(errorMessage.str());
+			}
+			else if (HAS_FIXED_SIZE && (numberOfRows != FIXED_NUMBER_OF_ROWS || numberOfColumns != FIXED_NUMBER_OF_COLUMNS)) {
+				std::stringstream errorMessage;
+				errorMessage << "A board with " << numberOfRows << " rows and " << numberOfColumns << " columns does not match the board type with " <<
+					FIXED_NUMBER_OF_ROWS << " rows and " << FIXED_NUMBER_OF_COLUMNS << " columns.";
+				throw std::logic_error(errorMessage.str());
+			}
+			else if (winLength < 2 || winLength > MAXIMUM_WIN_LENGTH || (HAS_FIXED_SIZE && winLength != DEFAULT_WIN_LENGTH)) {
+				std::stringstream errorMessage;
+				errorMessage << "A board with " << numberOfRows << " rows and " << numberOfColumns << " columns cannot be played to " << winLength << " coins in a row.";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			this->numberOfRows = static_cast<std::uint8_t>(numberOfRows);
+			this->numberOfColumns = static_cast<std::uint8_t>(numberOfColumns);
+			this->winLength = static_cast<std::uint8_t>(winLength);
+			removeAllCoins();
+
+			this->bottomBits = Bitboard();
+			for (int columnCounter = 0; columnCounter < numberOfColumns; ++columnCounter) {
+				this->bottomBits.setBit(getBitNumber(columnCounter, 0));
+			}
+			this->boardBits = (this->bottomBits << numberOfRows) - this->bottomBits;
+
+			if constexpr (HAS_FIXED_SIZE) {
+				this->windowTable = &WindowTableType::getWindowTable();
+			}
+			else {
+				this->windowTable = &WindowTableType::getWindowTable(numberOfRows, numberOfColumns, winLength);
+			}
+			this->forceDropAllowed = forceDropAllowed;
+
+		}
+
+		//Empty the board without changing its size
+		void removeAllCoins() {
+
+			this->userCoins = Bitboard();
+			this->computerCoins = Bitboard();
+			this->zobristHash = 0;
+			this->mirroredZobristHash = 0;
+			for (int columnCounter = 0; columnCounter < MAXIMUM_NUMBER_OF_COLUMNS; ++columnCounter) {
+				this->columnHeights[columnCounter] = 0;
+			}
+			this->numberOfCoins = 0;
+
+		}
+
+		//Return the position of the bit used for a cell given its column and its height counted from the bottom row
+		int getBitNumber(int columnNumber, int heightInColumn) const {
+
+			return columnNumber * (getNumberOfRows() + 1) + heightInColumn;
+
+		}
+
+		//Return the bit used for a cell given its column and its height counted from the bottom row
+		Bitboard getBit(int columnNumber, int heightInColumn) const {
+
+			return Bitboard::getBit(getBitNumber(columnNumber, heightInColumn));
+
+		}
+
+		//Random number for a coin of each player at each bit of the board. The numbers come from a fixed seed so that a
+		//position hashes to the same value in every run and on boards with bitboards of any number of words.
+		static std::uint64_t getZobristKey(int bitNumber, bool isUserCoin) {
+
+			static const std::vector<std::uint64_t> zobristKeys = []() {
+				std::vector<std::uint64_t> keys(2 * Bitboard::NUMBER_OF_BITS);
+				std::uint64_t seed = 0x9E3779B97F4A7C15ULL;
+				for (std::uint64_t& key : keys) {
+					//SplitMix64 generator
+					seed += 0x9E3779B97F4A7C15ULL;
+					key = seed;
+					key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+					key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+					key = key ^ (key >> 31);
+				}
+				return keys;
+			}();
+
+			return zobristKeys[2 * bitNumber + (isUserCoin ? 1 : 0)];
+
+		}
+
+		//Return the bit number used for the cell at the board index
+		int getBitNumberAt(int boardIndex) const {
+
+			return getBitNumber(boardIndex % getNumberOfColumns(), getNumberOfRows() - 1 - boardIndex / getNumberOfColumns());
+
+		}
+
+		//Check for a winning line of coins in the bitboard by shifting it along each of the four directions. Each step
+		//doubles the length of the runs of coins found so far, so five in a row takes three steps, the same as four.
+		bool containsWinningLine(const Bitboard& coins) const {
+
+			const int shifts[] = { 1, getNumberOfRows(), getNumberOfRows() + 1, getNumberOfRows() + 2 };
+			for (int shift : shifts) {
+				Bitboard runs = coins;
+				for (int runLength = 1; runLength < getWinLength() && !runs.isEmpty(); ) {
+					int step = std::min(runLength, getWinLength() - runLength);
+					runs &= runs >> (step * shift);
+					runLength += step;
+				}
+				if (!runs.isEmpty()) {
+					return true;
+				}
+			}
+
+			return false;
+
+		}
 
 	public:
 
 		//Default constructor
-		GameBoard() {
+		BasicGameBoard() {
 
-			this->gameBoard = std::vector<GameSlot>(DEFAULT_NUMBER_OF_ROWS * DEFAULT_NUMBER_OF_COLUMNS, GameSlot::GameSlot());
-			this->numberOfRows = DEFAULT_NUMBER_OF_ROWS;
-			this->numberOfColumns = DEFAULT_NUMBER_OF_COLUMNS;
-			this->forceDropAllowed = false;
+			initialize(DEFAULT_NUMBER_OF_ROWS, DEFAULT_NUMBER_OF_COLUMNS, DEFAULT_WIN_LENGTH, false);
 
 		}
 
 		//Constructor with required number of rows and columns
-		GameBoard(int numberOfRows, int numberOfColumns) {
+		BasicGameBoard(int numberOfRows, int numberOfColumns) {
 
-			this->gameBoard = std::vector<GameSlot>(numberOfRows * numberOfColumns, GameSlot::GameSlot());
-			this->numberOfRows = numberOfRows;
-			this->numberOfColumns = numberOfColumns;
-			this->forceDropAllowed = false;
+			initialize(numberOfRows, numberOfColumns, DEFAULT_WIN_LENGTH, false);
 
 		}
 
-		//Constructor with a gameboard as parameter
-		GameBoard(std::vector<GameSlot> gameBoard) {
-			this->gameBoard = gameBoard;
-			this->forceDropAllowed = true;
+		//Constructor with required number of rows and columns and the number of coins in a row that wins
+		BasicGameBoard(int numberOfRows, int numberOfColumns, int winLength) {
+
+			initialize(numberOfRows, numberOfColumns, winLength, false);
+
 		}
 
-		int getNumberOfRows() {
-			return this->numberOfRows;
+		//Constructor with a gameboard of default dimensions as parameter
+		BasicGameBoard(std::vector<GameSlot> gameBoard) : BasicGameBoard(gameBoard, DEFAULT_NUMBER_OF_ROWS, DEFAULT_NUMBER_OF_COLUMNS) {
 		}
 
-		int getNumberOfColumns() {
-			return this->numberOfColumns;
+		//Constructor with a gameboard and its dimensions as parameters
+		BasicGameBoard(std::vector<GameSlot> gameBoard, int numberOfRows, int numberOfColumns) {
+
+			initialize(numberOfRows, numberOfColumns, DEFAULT_WIN_LENGTH, true);
+
+			if (gameBoard.size() != static_cast<std::size_t>(numberOfRows * numberOfColumns)) {
+				throw std::logic_error("The game board does not match the board dimensions");
+			}
+
+			//Stack the coins from the bottom row up so that the column heights are maintained
+			for (int columnNumber = 0; columnNumber < numberOfColumns; ++columnNumber) {
+				for (int rowNumber = numberOfRows - 1; rowNumber >= 0; --rowNumber) {
+					GameSlot gameSlot = gameBoard.at(rowNumber * numberOfColumns + columnNumber);
+					if (gameSlot.isEmpty()) {
+						break;
+					}
+					dropCoinUnchecked(columnNumber, gameSlot.hasUserCoin());
+				}
+			}
+
+		}
+
+		//Copy a board of another type with the same dimensions and win length, such as a board sized at run time into a
+		//board of fixed size or with a smaller bitboard for the search
+		template <int OTHER_NUMBER_OF_ROWS, int OTHER_NUMBER_OF_COLUMNS, int OTHER_NUMBER_OF_WORDS>
+		explicit BasicGameBoard(const BasicGameBoard<OTHER_NUMBER_OF_ROWS, OTHER_NUMBER_OF_COLUMNS, OTHER_NUMBER_OF_WORDS>& gameBoard) {
+
+			initialize(gameBoard.getNumberOfRows(), gameBoard.getNumberOfColumns(), gameBoard.getWinLength(), gameBoard.forceDropAllowed);
+
+			this->userCoins = Bitboard(gameBoard.userCoins);
+			this->computerCoins = Bitboard(gameBoard.computerCoins);
+			this->zobristHash = gameBoard.zobristHash;
+			this->mirroredZobristHash = gameBoard.mirroredZobristHash;
+			for (int columnCounter = 0; columnCounter < MAXIMUM_NUMBER_OF_COLUMNS; ++columnCounter) {
+				this->columnHeights[columnCounter] = gameBoard.columnHeights[columnCounter];
+			}
+			this->numberOfCoins = gameBoard.numberOfCoins;
+
+		}
+
+		int getNumberOfRows() const {
+			return HAS_FIXED_SIZE ? FIXED_NUMBER_OF_ROWS : this->numberOfRows;
+		}
+
+		int getNumberOfColumns() const {
+			return HAS_FIXED_SIZE ? FIXED_NUMBER_OF_COLUMNS : this->numberOfColumns;
+		}
+
+		//Return the number of coins in a row that wins
+		int getWinLength() const {
+			return HAS_FIXED_SIZE ? DEFAULT_WIN_LENGTH : this->winLength;
 		}
 
 		//Check if the column is valid according to the board dimensions
-		bool isValidColumn(int columnNumber) {
+		bool isValidColumn(int columnNumber) const {
 
-			if (columnNumber >= 0 && columnNumber < this->numberOfColumns) {
+			if (columnNumber >= 0 && columnNumber < getNumberOfColumns()) {
 				return true;
 			}
 			else {
@@ -66,23 +293,23 @@ namespace model {
 		}
 
 		//Return the row number starting with zero
-		int getRowNumber(int boardIndex) {
+		int getRowNumber(int boardIndex) const {
 
-			return boardIndex / this->numberOfColumns;
+			return boardIndex / getNumberOfColumns();
 
 		}
 
 		//Return the column number starting with zero
-		int getColumnNumber(int boardIndex) {
+		int getColumnNumber(int boardIndex) const {
 
-			return boardIndex % this->numberOfColumns;
+			return boardIndex % getNumberOfColumns();
 
 		}
 
 		//Return index corresponding to row and column numbers passed in as parameters
-		int getBoardIndex(int rowNumber, int columnNumber) {
-			if (rowNumber <= this->numberOfRows - 1 && columnNumber <= this->numberOfColumns - 1) {
-				return rowNumber * this->numberOfColumns + columnNumber;
+		int getBoardIndex(int rowNumber, int columnNumber) const {
+			if (rowNumber <= getNumberOfRows() - 1 && columnNumber <= getNumberOfColumns() - 1) {
+				return rowNumber * getNumberOfColumns() + columnNumber;
 			}
 			else {
 				std::stringstream errorMessage;
@@ -91,11 +318,11 @@ namespace model {
 			}
 		}
 
-		int getDiagonalCellToRightGoingUp(int boardIndex) {
+		int getDiagonalCellToRightGoingUp(int boardIndex) const {
 
 			int rowNumber = getRowNumber(boardIndex);
 			int columnNumber = getColumnNumber(boardIndex);
-			if (rowNumber != 0 && columnNumber != this->numberOfColumns - 1) {
+			if (rowNumber != 0 && columnNumber != getNumberOfColumns() - 1) {
 				return getBoardIndex(rowNumber - 1, columnNumber + 1);
 			}
 			else {
@@ -106,11 +333,11 @@ namespace model {
 
 		}
 
-		int getDiagonalCellToRightGoingDown(int boardIndex) {
+		int getDiagonalCellToRightGoingDown(int boardIndex) const {
 
 			int rowNumber = getRowNumber(boardIndex);
 			int columnNumber = getColumnNumber(boardIndex);
-			if (rowNumber != this->numberOfRows - 1 && columnNumber != this->numberOfColumns - 1) {
+			if (rowNumber != getNumberOfRows() - 1 && columnNumber != getNumberOfColumns() - 1) {
 				return getBoardIndex(rowNumber + 1, columnNumber + 1);
 			}
 			else {
@@ -121,9 +348,10 @@ namespace model {
 
 		}
 
-		bool isEmptyAt(int boardIndex) {
+		bool isEmptyAt(int boardIndex) const {
 
-			if (this->gameBoard.at(boardIndex).isEmpty()) {
+			int bitNumber = getBitNumberAt(boardIndex);
+			if (!this->userCoins.hasBit(bitNumber) && !this->computerCoins.hasBit(bitNumber)) {
 				return true;
 			}
 			else {
@@ -132,9 +360,384 @@ namespace model {
 
 		}
 
-		GameSlot getGameSlot(int boardIndex) {
+		GameSlot getGameSlot(int boardIndex) const {
+
+			GameSlot gameSlot;
+			int bitNumber = getBitNumberAt(boardIndex);
+			if (this->userCoins.hasBit(bitNumber)) {
+				gameSlot.putCoin(true);
+			}
+			else if (this->computerCoins.hasBit(bitNumber)) {
+				gameSlot.putCoin(false);
+			}
 
-			return this->gameBoard.at(boardIndex);
+			return gameSlot;
+
+		}
+
+		//Return the bitboard of the coins of one player. Each column takes numberOfRows + 1 bits starting from the bottom
+		//row with the top bit always clear.
+		const Bitboard& getCoinBits(bool isUserCoin) const {
+
+			return isUserCoin ? this->userCoins : this->computerCoins;
+
+		}
+
+		//Check if a board of the given size can be packed into one word by getPackedPosition
+		static bool fitsPackedPosition(int numberOfRows, int numberOfColumns) {
+
+			return (numberOfRows + 1) * numberOfColumns <= NUMBER_OF_BITS_IN_PACKED_POSITION;
+
+		}
+
+		//Return the coins and column heights packed into one word: the user coins plus a bit right above the top coin of
+		//every column, which for a full column is the extra bit on top of it. Every slot below that bit holds a coin, so
+		//a clear bit there is a computer coin. The word is only read back by a board of the same size. Boards too large
+		//for one word cannot be packed.
+		std::uint64_t getPackedPosition() const {
+
+			if (!fitsPackedPosition(getNumberOfRows(), getNumberOfColumns())) {
+				std::stringstream errorMessage;
+				errorMessage << "A board with " << getNumberOfRows() << " rows and " << getNumberOfColumns() << " columns does not fit into a packed position.";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			return (this->userCoins | ((this->userCoins | this->computerCoins) + this->bottomBits)).getWord(0);
+
+		}
+
+		//Return the packed position of the board with the canonical hash, which is the mirror image of this board when
+		//that hashes lower. Columns saved with it are turned around by getCanonicalColumn.
+		std::uint64_t getCanonicalPackedPosition() const {
+
+			std::uint64_t packedPosition = getPackedPosition();
+			if (this->mirroredZobristHash >= this->zobristHash) {
+				return packedPosition;
+			}
+
+			std::uint64_t columnMask = getNumberOfRows() + 1 < NUMBER_OF_BITS_IN_PACKED_POSITION ? (std::uint64_t(1) << (getNumberOfRows() + 1)) - 1 : ~std::uint64_t(0);
+			std::uint64_t mirroredPackedPosition = 0;
+			for (int columnCounter = 0; columnCounter < getNumberOfColumns(); ++columnCounter) {
+				mirroredPackedPosition |= ((packedPosition >> getBitNumber(columnCounter, 0)) & columnMask) << getBitNumber(getMirroredColumn(columnCounter), 0);
+			}
+			return mirroredPackedPosition;
+
+		}
+
+		//Set the board to a position packed by getPackedPosition
+		void setPackedPosition(std::uint64_t packedPosition) {
+
+			if (!fitsPackedPosition(getNumberOfRows(), getNumberOfColumns())) {
+				std::stringstream errorMessage;
+				errorMessage << "A board with " << getNumberOfRows() << " rows and " << getNumberOfColumns() << " columns does not fit into a packed position.";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			std::uint64_t columnMask = getNumberOfRows() + 1 < NUMBER_OF_BITS_IN_PACKED_POSITION ? (std::uint64_t(1) << (getNumberOfRows() + 1)) - 1 : ~std::uint64_t(0);
+			if ((packedPosition & ~(this->bottomBits.getWord(0) * columnMask)) != 0) {
+				std::stringstream errorMessage;
+				errorMessage << "Packed position " << packedPosition << " has bits outside a board with " << getNumberOfRows() << " rows and " << getNumberOfColumns() << " columns.";
+				throw std::logic_error(errorMessage.str());
+			}
+			for (int columnCounter = 0; columnCounter < getNumberOfColumns(); ++columnCounter) {
+				if (((packedPosition >> getBitNumber(columnCounter, 0)) & columnMask) == 0) {
+					std::stringstream errorMessage;
+					errorMessage << "Packed position " << packedPosition << " has no height for column " << columnCounter << ".";
+					throw std::logic_error(errorMessage.str());
+				}
+			}
+
+			removeAllCoins();
+			for (int columnCounter = 0; columnCounter < getNumberOfColumns(); ++columnCounter) {
+
+				int columnShift = getBitNumber(columnCounter, 0), mirroredColumnShift = getBitNumber(getMirroredColumn(columnCounter), 0);
+				std::uint64_t columnBits = (packedPosition >> columnShift) & columnMask;
+				int columnHeight = getNumberOfRows();
+				while (((columnBits >> columnHeight) & 1) == 0) {
+					--columnHeight;
+				}
+
+				//Set the coins of the column at once and hash them one at a time
+				std::uint64_t coinMask = (std::uint64_t(1) << columnHeight) - 1;
+				this->userCoins |= Bitboard((columnBits & coinMask) << columnShift);
+				this->computerCoins |= Bitboard((~columnBits & coinMask) << columnShift);
+				for (int heightInColumn = 0; heightInColumn < columnHeight; ++heightInColumn) {
+					bool isUserCoin = ((columnBits >> heightInColumn) & 1) != 0;
+					this->zobristHash ^= getZobristKey(columnShift + heightInColumn, isUserCoin);
+					this->mirroredZobristHash ^= getZobristKey(mirroredColumnShift + heightInColumn, isUserCoin);
+				}
+				this->columnHeights[columnCounter] = static_cast<std::uint8_t>(columnHeight);
+				this->numberOfCoins = static_cast<std::uint16_t>(this->numberOfCoins + columnHeight);
+			}
+
+		}
+
+		//Return the bits of every slot of the board, leaving out the extra bit on top of each column
+		const Bitboard& getBoardBits() const {
+
+			return this->boardBits;
+
+		}
+
+		//Return the bits of the slots the next coin dropped into each column would land in. Full columns have none.
+		Bitboard getDropBits() const {
+
+			return ((this->userCoins | this->computerCoins) + this->bottomBits) & this->boardBits;
+
+		}
+
+		//Return the empty slots where a coin of the player would complete a winning line, whether or not a coin can be
+		//dropped there yet. Every slot is checked at once by shifting the bitboard along each of the four directions.
+		Bitboard getWinningBits(bool isUserCoin) const {
+
+			const Bitboard& coins = isUserCoin ? this->userCoins : this->computerCoins;
+			int coinsToWin = getWinLength() - 1;
+
+			//The rest of the line right below the slot
+			Bitboard winningBits = coins << 1;
+			for (int distance = 2; distance <= coinsToWin; ++distance) {
+				winningBits &= coins << distance;
+			}
+
+			//The rest of the line through the slot, with the slot at either end or in between. The runs of coins on each
+			//side are built up one step at a time and every split of the line between the two sides is tried.
+			const int shifts[] = { getNumberOfRows(), getNumberOfRows() + 1, getNumberOfRows() + 2 };
+			for (int shift : shifts) {
+
+				Bitboard runsBelow[MAXIMUM_WIN_LENGTH];
+				runsBelow[0] = ~Bitboard();
+				for (int distance = 1; distance <= coinsToWin; ++distance) {
+					runsBelow[distance] = runsBelow[distance - 1] & (coins << (distance * shift));
+				}
+
+				Bitboard runsAbove = ~Bitboard();
+				winningBits |= runsBelow[coinsToWin];
+				for (int distance = 1; distance <= coinsToWin; ++distance) {
+					runsAbove &= coins >> (distance * shift);
+					winningBits |= runsAbove & runsBelow[coinsToWin - distance];
+				}
+			}
+
+			return winningBits & this->boardBits & ~(this->userCoins | this->computerCoins);
+
+		}
+
+		//Return the bit of the slot that the next coin dropped into the column will land in. The column is not checked.
+		Bitboard getDropBit(int columnNumber) const {
+
+			return getBit(columnNumber, this->columnHeights[columnNumber]);
+
+		}
+
+		//Return the bit number of the slot that the next coin dropped into the column will land in
+		int getDropBitNumber(int columnNumber) const {
+
+			return getBitNumber(columnNumber, this->columnHeights[columnNumber]);
+
+		}
+
+		//Return the Zobrist hash of the coins on the board. It is updated as coins are dropped and taken back out.
+		std::uint64_t getHash() const {
+
+			return this->zobristHash;
+
+		}
+
+		//Return the hash the board would have if it were flipped left to right
+		std::uint64_t getMirroredHash() const {
+
+			return this->mirroredZobristHash;
+
+		}
+
+		//A board and its mirror image have the same value, so caches store both under the smaller of their two hashes.
+		//Moves saved with the hash are saved as they are played on the board with that hash.
+		std::uint64_t getCanonicalHash() const {
+
+			return std::min(this->zobristHash, this->mirroredZobristHash);
+
+		}
+
+		//Turn a column of this board into the column of the board with the canonical hash, or back. Flipping the board
+		//twice gives the same board, so both ways are the same. No move (-1) stays no move.
+		int getCanonicalColumn(int columnNumber) const {
+
+			return columnNumber >= 0 && this->mirroredZobristHash < this->zobristHash ? getMirroredColumn(columnNumber) : columnNumber;
+
+		}
+
+		//Return the column on the other side of the board at the same distance from the center
+		int getMirroredColumn(int columnNumber) const {
+
+			return getNumberOfColumns() - 1 - columnNumber;
+
+		}
+
+		//Check if the board is its own mirror image. The hashes rule out almost every board before the columns are compared.
+		bool isSymmetric() const {
+
+			if (this->zobristHash != this->mirroredZobristHash) {
+				return false;
+			}
+
+			int bitsInColumn = getNumberOfRows() + 1;
+			for (int columnCounter = 0; columnCounter < getNumberOfColumns() / 2; ++columnCounter) {
+				int columnShift = getBitNumber(columnCounter, 0), mirroredColumnShift = getBitNumber(getMirroredColumn(columnCounter), 0);
+				if (this->userCoins.getBits(columnShift, bitsInColumn) != this->userCoins.getBits(mirroredColumnShift, bitsInColumn) ||
+					this->computerCoins.getBits(columnShift, bitsInColumn) != this->computerCoins.getBits(mirroredColumnShift, bitsInColumn)) {
+					return false;
+				}
+			}
+
+			return true;
+
+		}
+
+		//Check if the move scores the same as a move further left because the board is its own mirror image, so that the
+		//search can leave it out
+		bool isMirrorOfEarlierMove(int columnNumber) const {
+
+			return 2 * columnNumber > getNumberOfColumns() - 1 && isSymmetric();
+
+		}
+
+		//Return the number of coins on the board
+		int getNumberOfCoins() const {
+
+			return this->numberOfCoins;
+
+		}
+
+		//Return the number of coins already in the column
+		int getColumnHeight(int columnNumber) const {
+
+			return this->columnHeights[columnNumber];
+
+		}
+
+		//Return the row number of the slot that the next coin dropped into the column will land in
+		int getAvailableRow(int columnNumber) const {
+
+			return getNumberOfRows() - 1 - this->columnHeights[columnNumber];
+
+		}
+
+		//Return the board index of the slot that the next coin dropped into the column will land in. The column is not
+		//checked.
+		int getAvailableSlot(int columnNumber) const {
+
+			return (getNumberOfRows() - 1 - this->columnHeights[columnNumber]) * getNumberOfColumns() + columnNumber;
+
+		}
+
+		//Check if the top coin of the column belongs to the user. The column must have a coin in it.
+		bool isUserCoinOnTop(int columnNumber) const {
+
+			assert(this->columnHeights[columnNumber] > 0);
+			return this->userCoins.hasBit(getBitNumber(columnNumber, this->columnHeights[columnNumber] - 1));
+
+		}
+
+		//Return the windows of the board, shared by every board of the same size
+		const WindowTableType& getWindowTable() const {
+
+			if constexpr (HAS_FIXED_SIZE) {
+				return WindowTableType::getWindowTable();
+			}
+			else {
+				return *this->windowTable;
+			}
+
+		}
+
+		//Check if a coin can be dropped into the column
+		bool canDropCoin(int columnNumber) const {
+
+			return isValidColumn(columnNumber) && this->columnHeights[columnNumber] < getNumberOfRows();
+
+		}
+
+		//Check if there is no more room on the board
+		bool isFull() const {
+
+			return this->numberOfCoins == getNumberOfRows() * getNumberOfColumns();
+
+		}
+
+		//Check if the user or the computer has a winning line of coins
+		bool hasWinningLine(bool isUserCoin) const {
+
+			return containsWinningLine(isUserCoin ? this->userCoins : this->computerCoins);
+
+		}
+
+		//Check if dropping a coin into the column would complete a winning line without changing the board
+		bool isWinningDrop(int columnNumber, bool isUserCoin) const {
+
+			Bitboard coins = isUserCoin ? this->userCoins : this->computerCoins;
+			coins.setBit(getBitNumber(columnNumber, this->columnHeights[columnNumber]));
+			return containsWinningLine(coins);
+
+		}
+
+		//Drop a coin into the column. The column has to have room for the coin.
+		void dropCoin(int columnNumber, bool isUserCoin) {
+
+			if (!canDropCoin(columnNumber)) {
+				std::stringstream errorMessage;
+				errorMessage << "Cannot drop a coin into column " << columnNumber << ".";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			dropCoinUnchecked(columnNumber, isUserCoin);
+
+		}
+
+		//Drop a coin into the column without validating it. Used by the search, which only plays columns with room.
+		void dropCoinUnchecked(int columnNumber, bool isUserCoin) {
+
+			assert(columnNumber >= 0 && columnNumber < getNumberOfColumns() && this->columnHeights[columnNumber] < getNumberOfRows());
+
+			int heightInColumn = this->columnHeights[columnNumber]++;
+			int bitNumber = getBitNumber(columnNumber, heightInColumn);
+			this->zobristHash ^= getZobristKey(bitNumber, isUserCoin);
+			this->mirroredZobristHash ^= getZobristKey(getBitNumber(getMirroredColumn(columnNumber), heightInColumn), isUserCoin);
+			if (isUserCoin) {
+				this->userCoins.setBit(bitNumber);
+			}
+			else {
+				this->computerCoins.setBit(bitNumber);
+			}
+			++this->numberOfCoins;
+
+		}
+
+		//Take the top coin back out of the column. Used by the search to undo a simulated drop.
+		void undoCoin(int columnNumber) {
+
+			if (!isValidColumn(columnNumber) || this->columnHeights[columnNumber] == 0) {
+				std::stringstream errorMessage;
+				errorMessage << "Cannot take a coin out of column " << columnNumber << ".";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			undoCoinUnchecked(columnNumber);
+
+		}
+
+		//Take the top coin back out of the column without validating it
+		void undoCoinUnchecked(int columnNumber) {
+
+			assert(columnNumber >= 0 && columnNumber < getNumberOfColumns() && this->columnHeights[columnNumber] > 0);
+
+			int heightInColumn = --this->columnHeights[columnNumber];
+			int bitNumber = getBitNumber(columnNumber, heightInColumn);
+			bool isUserCoin = this->userCoins.hasBit(bitNumber);
+			this->zobristHash ^= getZobristKey(bitNumber, isUserCoin);
+			this->mirroredZobristHash ^= getZobristKey(getBitNumber(getMirroredColumn(columnNumber), heightInColumn), isUserCoin);
+			this->userCoins.clearBit(bitNumber);
+			this->computerCoins.clearBit(bitNumber);
+			--this->numberOfCoins;
 
 		}
 
@@ -142,16 +745,9 @@ namespace model {
 
 			if (this->forceDropAllowed) {
 
-				//Find the top and bottom rows in the columns
-				int bottomRowInColumn = columnNumber + this->numberOfColumns * (this->numberOfRows - 1);
-				int topRowInColumn = columnNumber;
-
-				//Start with bottom row and go one cell above at a time till an empty one is found
-				for (int slotCounter = bottomRowInColumn; slotCounter >= topRowInColumn; slotCounter -= this->numberOfColumns) {
-					if (this->gameBoard.at(slotCounter).isEmpty()) {
-						this->gameBoard.at(slotCounter).putCoin(isUserCoin);
-						break;
-					}
+				//Coin is dropped only if there is an empty slot in the column
+				if (canDropCoin(columnNumber)) {
+					dropCoinUnchecked(columnNumber, isUserCoin);
 				}
 
 			}
@@ -164,4 +760,33 @@ namespace model {
 
 	};
 
+	//Board sized at run time, up to 20 by 20
+	typedef BasicGameBoard<> GameBoard;
+
+	//Board sized at run time whose slots fit into one word, for the searches on boards up to the size of 7 by 8
+	typedef BasicGameBoard<0, 0, 1> SmallGameBoard;
+
+	//Create a search on the board type that suits the board. Connect Four on the common sizes gets a board compiled for
+	//its size. Other boards that fit into one word get a one word board, and the rest a board large enough for any
+	//board. The search is the template instantiated on the board type, made from the given arguments.
+	template <typename SearchType, template <typename> class BasicSearchType, typename... ArgumentTypes>
+	std::unique_ptr<SearchType> createForBoardType(int numberOfRows, int numberOfColumns, int winLength, ArgumentTypes&&... arguments) {
+
+		if (winLength == GameBoard::DEFAULT_WIN_LENGTH && numberOfRows == 6 && numberOfColumns == 7) {
+			return std::unique_ptr<SearchType>(new BasicSearchType<BasicGameBoard<6, 7>>(std::forward<ArgumentTypes>(arguments)...));
+		}
+		else if (winLength == GameBoard::DEFAULT_WIN_LENGTH && numberOfRows == 7 && numberOfColumns == 8) {
+			return std::unique_ptr<SearchType>(new BasicSearchType<BasicGameBoard<7, 8>>(std::forward<ArgumentTypes>(arguments)...));
+		}
+		else if (winLength == GameBoard::DEFAULT_WIN_LENGTH && numberOfRows == 8 && numberOfColumns == 9) {
+			return std::unique_ptr<SearchType>(new BasicSearchType<BasicGameBoard<8, 9>>(std::forward<ArgumentTypes>(arguments)...));
+		}
+		else if ((numberOfRows + 1) * numberOfColumns <= SmallGameBoard::MAXIMUM_NUMBER_OF_SLOTS) {
+			return std::unique_ptr<SearchType>(new BasicSearchType<SmallGameBoard>(std::forward<ArgumentTypes>(arguments)...));
+		}
+		else {
+			return std::unique_ptr<SearchType>(new BasicSearchType<GameBoard>(std::forward<ArgumentTypes>(arguments)...));
+		}
+	}
+
 }
\ No newline at end of file
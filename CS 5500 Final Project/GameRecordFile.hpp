@@ -0,0 +1,531 @@
+#pragma once
+
+#include <tbb\blocked_range.h>
+#include <tbb\parallel_for.h>
+
+#include "GameBoard.hpp"
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace controller {
+
+	//What the records of a file are
+	//   positions   the coins and column heights of a board packed into 8 bytes
+	//   games       the columns played in a game, one nibble per move
+	enum class GameRecordKind : std::uint8_t { positions = 1, games = 2 };
+
+	//How a recorded game ended
+	enum class GameOutcome : std::uint8_t { unfinished, userWon, computerWon, draw };
+
+	//Start of a game record file. The records follow it.
+	struct GameRecordHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint8_t numberOfRows;
+		std::uint8_t numberOfColumns;
+		GameRecordKind recordKind;
+		std::uint8_t reserved;
+		std::uint64_t numberOfRecords;
+		std::uint64_t reserved2;
+	};
+
+	static_assert(sizeof(GameRecordHeader) == 32, "The game record header is written to the file as it is laid out in memory.");
+
+	//One recorded game read in place. The record is the number of moves, a byte with the player who went first in its low
+	//bit and the outcome above it, and then the columns played, two to a byte with the earlier move in the low nibble.
+	//Records are only written for boards of at most 16 columns, so every column fits into a nibble.
+	class GameRecordView {
+
+	private:
+
+		//Members
+		const unsigned char* record;
+
+	public:
+
+		//Bytes in front of the moves
+		const static int HEADER_SIZE = 2;
+
+		//Largest number of moves a record can hold
+		const static int MAXIMUM_NUMBER_OF_MOVES = 255;
+
+		//Largest number of columns a move of a record can go in
+		const static int MAXIMUM_NUMBER_OF_COLUMNS = 16;
+
+		//Bytes a game with the number of moves takes
+		static std::size_t getRecordSize(int numberOfMoves) {
+
+			return HEADER_SIZE + (numberOfMoves + 1) / 2;
+
+		}
+
+		explicit GameRecordView(const unsigned char* record) : record(record) {
+		}
+
+		//Return the first byte of the record in the mapped file
+		const unsigned char* getRecord() const {
+
+			return this->record;
+
+		}
+
+		int getNumberOfMoves() const {
+
+			return this->record[0];
+
+		}
+
+		bool isFirstPlayerUser() const {
+
+			return (this->record[1] & 1) != 0;
+
+		}
+
+		GameOutcome getOutcome() const {
+
+			return static_cast<GameOutcome>(this->record[1] >> 1);
+
+		}
+
+		//Return the column of a move, counting the first move as 0
+		int getMove(int moveNumber) const {
+
+			return (this->record[HEADER_SIZE + moveNumber / 2] >> (4 * (moveNumber % 2))) & 0xF;
+
+		}
+
+		std::size_t getSize() const {
+
+			return getRecordSize(getNumberOfMoves());
+
+		}
+
+		//Play the first moves of the game on an empty board. A move that does not fit the board throws.
+		template <typename GameBoardType>
+		void replay(GameBoardType& gameBoard, int numberOfMoves) const {
+
+			bool isUserCoin = isFirstPlayerUser();
+			for (int moveCounter = 0; moveCounter < numberOfMoves; ++moveCounter) {
+				gameBoard.dropCoin(getMove(moveCounter), isUserCoin);
+				isUserCoin = isUserCoin ? false : true;
+			}
+
+		}
+
+	};
+
+	//Writes positions or games to a file as they come. Records are collected in a buffer and written out in blocks, and
+	//the number of records is filled into the header when the file is closed. The file is only complete once close has
+	//been called.
+	class GameRecordWriter {
+
+	private:
+
+		//Constants
+		const static std::size_t BUFFER_SIZE = 64 * 1024;
+
+		//Members
+		std::string filePath;
+		std::ofstream recordFile;
+		GameRecordHeader header;
+		std::vector<unsigned char> buffer;
+
+		void throwWriteError() {
+
+			std::stringstream errorMessage;
+			errorMessage << "Cannot write game records " << this->filePath << ".";
+			throw std::runtime_error(errorMessage.str());
+
+		}
+
+		void flush() {
+
+			this->recordFile.write(reinterpret_cast<const char*>(this->buffer.data()), this->buffer.size());
+			this->buffer.clear();
+			if (!this->recordFile) {
+				throwWriteError();
+			}
+
+		}
+
+		void checkRecordKind(GameRecordKind recordKind) {
+
+			if (this->header.recordKind != recordKind) {
+				std::stringstream errorMessage;
+				errorMessage << "Game records " << this->filePath << " hold another kind of record.";
+				throw std::logic_error(errorMessage.str());
+			}
+			else if (!this->recordFile.is_open()) {
+				std::stringstream errorMessage;
+				errorMessage << "Game records " << this->filePath << " are already closed.";
+				throw std::logic_error(errorMessage.str());
+			}
+
+		}
+
+	public:
+
+		//Version of the file layout, checked when the file is read
+		const static std::uint32_t FILE_VERSION = 1;
+
+		static const char* getMagic() {
+
+			return "C4GAMES\0";
+
+		}
+
+		//Start a file of records for boards of the given size, replacing any file already there
+		GameRecordWriter(const std::string& filePath, int numberOfRows, int numberOfColumns, GameRecordKind recordKind) :
+			filePath(filePath), recordFile(filePath, std::ios::binary | std::ios::trunc) {
+
+			//Throws if the board does not fit into one word, since positions are packed into one
+			model::SmallGameBoard gameBoard(numberOfRows, numberOfColumns);
+			if (numberOfColumns > GameRecordView::MAXIMUM_NUMBER_OF_COLUMNS) {
+				std::stringstream errorMessage;
+				errorMessage << "A board with " << numberOfColumns << " columns has more columns than game records can hold.";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			std::memset(&this->header, 0, sizeof(this->header));
+			std::memcpy(this->header.magic, getMagic(), sizeof(this->header.magic));
+			this->header.version = FILE_VERSION;
+			this->header.numberOfRows = static_cast<std::uint8_t>(numberOfRows);
+			this->header.numberOfColumns = static_cast<std::uint8_t>(numberOfColumns);
+			this->header.recordKind = recordKind;
+			this->buffer.reserve(BUFFER_SIZE);
+
+			//The header is written again with the number of records when the file is closed
+			this->recordFile.write(reinterpret_cast<const char*>(&this->header), sizeof(this->header));
+			if (!this->recordFile) {
+				throwWriteError();
+			}
+
+		}
+
+		//Close the file if the writer was not closed. A destructor cannot report that the records were not all written,
+		//so callers that need to know close the writer themselves.
+		~GameRecordWriter() {
+
+			try {
+				close();
+			}
+			catch (...) {
+			}
+
+		}
+
+		GameRecordWriter(const GameRecordWriter&) = delete;
+		GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+		//Add the position on a board of the size of the file
+		template <typename GameBoardType>
+		void writePosition(const GameBoardType& gameBoard) {
+
+			checkRecordKind(GameRecordKind::positions);
+			if (gameBoard.getNumberOfRows() != this->header.numberOfRows || gameBoard.getNumberOfColumns() != this->header.numberOfColumns) {
+				throw std::logic_error("The board does not match the board dimensions of the game records.");
+			}
+
+			if (this->buffer.size() + sizeof(std::uint64_t) > BUFFER_SIZE) {
+				flush();
+			}
+
+			std::uint64_t packedPosition = gameBoard.getPackedPosition();
+			const unsigned char* packedBytes = reinterpret_cast<const unsigned char*>(&packedPosition);
+			this->buffer.insert(this->buffer.end(), packedBytes, packedBytes + sizeof(packedPosition));
+			++this->header.numberOfRecords;
+
+		}
+
+		//Add a game given by the columns played in turn, starting with the first player
+		void writeGame(const int* moves, int numberOfMoves, bool firstPlayerIsUser, GameOutcome outcome) {
+
+			checkRecordKind(GameRecordKind::games);
+			if (numberOfMoves < 0 || numberOfMoves > this->header.numberOfRows * this->header.numberOfColumns || numberOfMoves > GameRecordView::MAXIMUM_NUMBER_OF_MOVES) {
+				std::stringstream errorMessage;
+				errorMessage << "A game of " << numberOfMoves << " moves does not fit on a board with " << static_cast<int>(this->header.numberOfRows) <<
+					" rows and " << static_cast<int>(this->header.numberOfColumns) << " columns.";
+				throw std::logic_error(errorMessage.str());
+			}
+			for (int moveCounter = 0; moveCounter < numberOfMoves; ++moveCounter) {
+				if (moves[moveCounter] < 0 || moves[moveCounter] >= this->header.numberOfColumns) {
+					std::stringstream errorMessage;
+					errorMessage << "Move " << moveCounter << " of the game is column " << moves[moveCounter] << ", which is not on the board.";
+					throw std::logic_error(errorMessage.str());
+				}
+			}
+
+			if (this->buffer.size() + GameRecordView::getRecordSize(numberOfMoves) > BUFFER_SIZE) {
+				flush();
+			}
+
+			this->buffer.push_back(static_cast<unsigned char>(numberOfMoves));
+			this->buffer.push_back(static_cast<unsigned char>((static_cast<int>(outcome) << 1) | (firstPlayerIsUser ? 1 : 0)));
+			for (int moveCounter = 0; moveCounter < numberOfMoves; ++moveCounter) {
+				if (moveCounter % 2 == 0) {
+					this->buffer.push_back(static_cast<unsigned char>(moves[moveCounter]));
+				}
+				else {
+					this->buffer.back() |= static_cast<unsigned char>(moves[moveCounter] << 4);
+				}
+			}
+			++this->header.numberOfRecords;
+
+		}
+
+		std::uint64_t getNumberOfRecords() const {
+
+			return this->header.numberOfRecords;
+
+		}
+
+		//Write out the records still in the buffer and the number of records in the header
+		void close() {
+
+			if (!this->recordFile.is_open()) {
+				return;
+			}
+
+			flush();
+			this->recordFile.seekp(0);
+			this->recordFile.write(reinterpret_cast<const char*>(&this->header), sizeof(this->header));
+			this->recordFile.close();
+			if (!this->recordFile) {
+				throwWriteError();
+			}
+
+		}
+
+	};
+
+	//File of positions or games mapped read-only into memory. Positions are read straight out of the mapping and games
+	//are walked in place with an iterator, so reading them allocates nothing. The records are stored in the byte order
+	//of the machine that wrote them. The bulk loaders rebuild the boards of every record in parallel.
+	class GameRecordReader {
+
+	private:
+
+		//Members
+		MappedFile mappedFile;
+		const GameRecordHeader* header;
+		const unsigned char* records;
+		const unsigned char* recordsEnd;
+
+		static void throwFileError(const std::string& filePath, const char* problem) {
+
+			MappedFile::throwFileError("game records", filePath, problem);
+
+		}
+
+		void checkRecordKind(GameRecordKind recordKind) const {
+
+			if (this->header->recordKind != recordKind) {
+				throw std::logic_error("The game record file holds another kind of record.");
+			}
+
+		}
+
+		//Empty board of the size of the file, copied for every board that is loaded
+		template <typename GameBoardType>
+		GameBoardType getEmptyGameBoard() const {
+
+			return GameBoardType(this->header->numberOfRows, this->header->numberOfColumns);
+
+		}
+
+	public:
+
+		//Iterates over the games of the file in the order they were written
+		class GameIterator {
+
+		private:
+
+			//Members
+			const unsigned char* record;
+
+		public:
+
+			typedef std::forward_iterator_tag iterator_category;
+			typedef GameRecordView value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const GameRecordView* pointer;
+			typedef GameRecordView reference;
+
+			explicit GameIterator(const unsigned char* record) : record(record) {
+			}
+
+			GameRecordView operator*() const {
+
+				return GameRecordView(this->record);
+
+			}
+
+			GameIterator& operator++() {
+
+				this->record += GameRecordView(this->record).getSize();
+				return *this;
+
+			}
+
+			bool operator==(const GameIterator& other) const {
+
+				return this->record == other.record;
+
+			}
+
+			bool operator!=(const GameIterator& other) const {
+
+				return this->record != other.record;
+
+			}
+
+		};
+
+		//Map the file and check that its records fill it exactly, so that reading them never runs past the mapping
+		explicit GameRecordReader(const std::string& filePath) : mappedFile(filePath, "game records") {
+
+			std::size_t mappedSize = this->mappedFile.getSize();
+			this->header = reinterpret_cast<const GameRecordHeader*>(this->mappedFile.getData());
+			this->records = this->mappedFile.getData() + sizeof(GameRecordHeader);
+			this->recordsEnd = this->mappedFile.getData() + mappedSize;
+
+			if (mappedSize < sizeof(GameRecordHeader) || std::memcmp(this->header->magic, GameRecordWriter::getMagic(), sizeof(this->header->magic)) != 0) {
+				throwFileError(filePath, "the file does not hold game records");
+			}
+			else if (this->header->version != GameRecordWriter::FILE_VERSION) {
+				throwFileError(filePath, "the records were written by a different version");
+			}
+
+			try {
+				model::SmallGameBoard gameBoard(this->header->numberOfRows, this->header->numberOfColumns);
+			}
+			catch (const std::logic_error&) {
+				throwFileError(filePath, "the board dimensions do not fit into the bitboard");
+			}
+			if (this->header->numberOfColumns > GameRecordView::MAXIMUM_NUMBER_OF_COLUMNS) {
+				throwFileError(filePath, "the board has more columns than game records can hold");
+			}
+
+			if (this->header->recordKind == GameRecordKind::positions) {
+				if (mappedSize != sizeof(GameRecordHeader) + this->header->numberOfRecords * sizeof(std::uint64_t)) {
+					throwFileError(filePath, "the file size does not match the number of positions");
+				}
+			}
+			else if (this->header->recordKind == GameRecordKind::games) {
+				const unsigned char* record = this->records;
+				for (std::uint64_t recordCounter = 0; recordCounter < this->header->numberOfRecords; ++recordCounter) {
+					if (record + GameRecordView::HEADER_SIZE > this->recordsEnd || record + GameRecordView(record).getSize() > this->recordsEnd) {
+						throwFileError(filePath, "the file ends in the middle of a game");
+					}
+					record += GameRecordView(record).getSize();
+				}
+				if (record != this->recordsEnd) {
+					throwFileError(filePath, "the file size does not match the number of games");
+				}
+			}
+			else {
+				throwFileError(filePath, "the kind of record is not known");
+			}
+
+		}
+
+		GameRecordReader(const GameRecordReader&) = delete;
+		GameRecordReader& operator=(const GameRecordReader&) = delete;
+
+		int getNumberOfRows() const {
+
+			return this->header->numberOfRows;
+
+		}
+
+		int getNumberOfColumns() const {
+
+			return this->header->numberOfColumns;
+
+		}
+
+		GameRecordKind getRecordKind() const {
+
+			return this->header->recordKind;
+
+		}
+
+		std::size_t getNumberOfRecords() const {
+
+			return static_cast<std::size_t>(this->header->numberOfRecords);
+
+		}
+
+		//Return a position of a file of positions as packed by GameBoard::getPackedPosition. The header is 32 bytes and the
+		//mapping starts on a page, so the positions are read in place as aligned words.
+		std::uint64_t getPackedPosition(std::size_t positionNumber) const {
+
+			return reinterpret_cast<const std::uint64_t*>(this->records)[positionNumber];
+
+		}
+
+		//First game of a file of games
+		GameIterator begin() const {
+
+			checkRecordKind(GameRecordKind::games);
+			return GameIterator(this->records);
+
+		}
+
+		GameIterator end() const {
+
+			return GameIterator(this->recordsEnd);
+
+		}
+
+		//Rebuild the board of every position of a file of positions
+		template <typename GameBoardType>
+		std::vector<GameBoardType> loadPositions() const {
+
+			checkRecordKind(GameRecordKind::positions);
+			std::vector<GameBoardType> gameBoards(getNumberOfRecords(), getEmptyGameBoard<GameBoardType>());
+			tbb::parallel_for(tbb::blocked_range<std::size_t>(0, gameBoards.size()), [this, &gameBoards](const tbb::blocked_range<std::size_t>& positionRange) {
+				for (std::size_t positionCounter = positionRange.begin(); positionCounter != positionRange.end(); ++positionCounter) {
+					gameBoards[positionCounter].setPackedPosition(getPackedPosition(positionCounter));
+				}
+			});
+
+			return gameBoards;
+
+		}
+
+		//Rebuild the board at the end of every game of a file of games. The games are found with one pass over the file
+		//and then replayed in parallel.
+		template <typename GameBoardType>
+		std::vector<GameBoardType> loadGames() const {
+
+			std::vector<const unsigned char*> gameRecords;
+			gameRecords.reserve(getNumberOfRecords());
+			for (GameIterator game = begin(); game != end(); ++game) {
+				gameRecords.push_back((*game).getRecord());
+			}
+
+			std::vector<GameBoardType> gameBoards(gameRecords.size(), getEmptyGameBoard<GameBoardType>());
+			tbb::parallel_for(tbb::blocked_range<std::size_t>(0, gameBoards.size()), [&gameRecords, &gameBoards](const tbb::blocked_range<std::size_t>& gameRange) {
+				for (std::size_t gameCounter = gameRange.begin(); gameCounter != gameRange.end(); ++gameCounter) {
+					GameRecordView gameRecordView(gameRecords[gameCounter]);
+					gameRecordView.replay(gameBoards[gameCounter], gameRecordView.getNumberOfMoves());
+				}
+			});
+
+			return gameBoards;
+
+		}
+
+	};
+
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <tbb\task_arena.h>
+
+#include "ConnectFourGame.hpp"
+#include "SearchResult.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace controller {
+
+	//Share of the worker threads a session gets when moves of several sessions are waiting
+	enum class SessionPriority { low, normal, high };
+
+	//Time from handing a user move to the session manager until the computer reply was ready
+	struct LatencyPercentiles {
+		std::uint64_t numberOfMoves;
+		std::chrono::microseconds median;
+		std::chrono::microseconds ninetiethPercentile;
+		std::chrono::microseconds ninetyNinthPercentile;
+		std::chrono::microseconds maximum;
+	};
+
+	//Outcome of a user move played through the session manager. There is no computer move if the user move was not valid
+	//or ended the game.
+	struct SessionMoveResult {
+		bool computerMoved;
+		SearchResult searchResult;
+		std::chrono::microseconds latency;
+	};
+
+	//Hosts many games at once. Every move computation runs in one of three shared task arenas, one per session priority,
+	//so the parallel searches of a game stay in the arena of its session. The arena of a higher priority is served first
+	//when worker threads are short, and each arena is capped at the same number of threads, so a few hard games cannot
+	//take over the machine. A session plays one move at a time, and a move is turned away instead of queued when its
+	//arena already has too many moves waiting. The latency of the last moves of each session is kept to report
+	//percentiles.
+	class GameSessionManager {
+
+	private:
+
+		//Constants
+		const static int NUMBER_OF_PRIORITIES = 3;
+		const static std::size_t DEFAULT_MAXIMUM_QUEUE_DEPTH = 1024;
+		const static std::size_t LATENCY_SAMPLES_PER_SESSION = 1024;
+		const static std::size_t DEFAULT_SESSION_TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES = 1;
+
+		struct GameSession {
+			std::unique_ptr<ConnectFourGame> connectFourGame;
+			SessionPriority priority;
+			std::mutex sessionMutex;
+			bool isMoveInProgress;
+			std::vector<std::chrono::microseconds> latencySamples;
+			std::size_t nextLatencySample;
+			std::uint64_t numberOfMoves;
+		};
+
+		//Members
+		std::mutex gameSessionsMutex;
+		std::map<int, std::shared_ptr<GameSession>> gameSessions;
+		int nextSessionId;
+		std::unique_ptr<tbb::task_arena> taskArenas[NUMBER_OF_PRIORITIES];
+		std::atomic<std::size_t> queueDepths[NUMBER_OF_PRIORITIES];
+		std::atomic<std::size_t> maximumQueueDepth;
+		std::mutex pendingMovesMutex;
+		std::condition_variable pendingMovesDone;
+
+		std::shared_ptr<GameSession> getGameSession(int sessionId) {
+
+			std::lock_guard<std::mutex> lock(this->gameSessionsMutex);
+			std::map<int, std::shared_ptr<GameSession>>::iterator gameSession = this->gameSessions.find(sessionId);
+			if (gameSession == this->gameSessions.end()) {
+				std::stringstream errorMessage;
+				errorMessage << "There is no game session " << sessionId << ".";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			return gameSession->second;
+
+		}
+
+		//Take a finished move off the queue of its arena. This happens before the result is handed out, so the next move
+		//of the session is admitted as soon as the caller sees the reply.
+		void finishMove(SessionPriority priority) {
+
+			std::lock_guard<std::mutex> lock(this->pendingMovesMutex);
+			--this->queueDepths[static_cast<int>(priority)];
+			this->pendingMovesDone.notify_all();
+
+		}
+
+		//Play the user move and the computer reply on a worker thread of the arena of the session. The game is only
+		//played on by the one move the session has in progress, so the search runs without the session lock, which is
+		//only taken for the latency samples and the move flag. A move submitted meanwhile is turned away at once.
+		void playUserMove(std::shared_ptr<GameSession> gameSession, int dropInColumn, std::chrono::steady_clock::time_point submitTime, std::shared_ptr<std::promise<SessionMoveResult>> moveResult) {
+
+			SessionMoveResult sessionMoveResult;
+			try {
+
+				int numberOfCoins = gameSession->connectFourGame->getNumberOfCoins();
+				gameSession->connectFourGame->dropCoin(dropInColumn);
+
+				sessionMoveResult.computerMoved = gameSession->connectFourGame->getNumberOfCoins() == numberOfCoins + 2;
+				sessionMoveResult.searchResult = gameSession->connectFourGame->getLastSearchResult();
+				sessionMoveResult.latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - submitTime);
+
+				std::lock_guard<std::mutex> lock(gameSession->sessionMutex);
+
+				//Keep the latest samples in a ring
+				if (gameSession->latencySamples.size() < LATENCY_SAMPLES_PER_SESSION) {
+					gameSession->latencySamples.push_back(sessionMoveResult.latency);
+				}
+				else {
+					gameSession->latencySamples[gameSession->nextLatencySample] = sessionMoveResult.latency;
+				}
+				gameSession->nextLatencySample = (gameSession->nextLatencySample + 1) % LATENCY_SAMPLES_PER_SESSION;
+				++gameSession->numberOfMoves;
+				gameSession->isMoveInProgress = false;
+			}
+			catch (...) {
+				{
+					std::lock_guard<std::mutex> lock(gameSession->sessionMutex);
+					gameSession->isMoveInProgress = false;
+				}
+				finishMove(gameSession->priority);
+				moveResult->set_exception(std::current_exception());
+				return;
+			}
+
+			finishMove(gameSession->priority);
+			moveResult->set_value(sessionMoveResult);
+
+		}
+
+	public:
+
+		//Each priority gets an arena of at most the given number of threads. Zero leaves it to TBB.
+		explicit GameSessionManager(int maximumConcurrency = 0) {
+
+			this->nextSessionId = 1;
+			this->maximumQueueDepth.store(DEFAULT_MAXIMUM_QUEUE_DEPTH);
+
+			const tbb::task_arena::priority arenaPriorities[NUMBER_OF_PRIORITIES] = { tbb::task_arena::priority::low, tbb::task_arena::priority::normal, tbb::task_arena::priority::high };
+			for (int priorityCounter = 0; priorityCounter < NUMBER_OF_PRIORITIES; ++priorityCounter) {
+				int arenaConcurrency = maximumConcurrency > 0 ? maximumConcurrency : tbb::task_arena::automatic;
+				this->taskArenas[priorityCounter].reset(new tbb::task_arena(arenaConcurrency, 0, arenaPriorities[priorityCounter]));
+				this->queueDepths[priorityCounter].store(0);
+			}
+
+		}
+
+		GameSessionManager(const GameSessionManager&) = delete;
+		GameSessionManager& operator=(const GameSessionManager&) = delete;
+
+		//Wait for the moves still being computed before the arenas go away
+		~GameSessionManager() {
+
+			std::unique_lock<std::mutex> lock(this->pendingMovesMutex);
+			this->pendingMovesDone.wait(lock, [this]() {
+				for (int priorityCounter = 0; priorityCounter < NUMBER_OF_PRIORITIES; ++priorityCounter) {
+					if (this->queueDepths[priorityCounter].load() != 0) {
+						return false;
+					}
+				}
+				return true;
+			});
+
+		}
+
+		//Start a game and return the number of its session. Hosting many games at once needs far smaller transposition
+		//tables than a single game, so each session gets a small one by default.
+		int createSession(int numberOfRows, int numberOfColumns, int gameDifficultyLevel, SessionPriority priority,
+			std::size_t transpositionTableSizeInMegabytes = DEFAULT_SESSION_TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES) {
+
+			std::shared_ptr<GameSession> gameSession(new GameSession());
+			gameSession->connectFourGame.reset(new ConnectFourGame(numberOfRows, numberOfColumns, model::GameBoard::DEFAULT_WIN_LENGTH, transpositionTableSizeInMegabytes));
+			gameSession->connectFourGame->setgameDifficultyLevel(gameDifficultyLevel);
+			gameSession->priority = priority;
+			gameSession->isMoveInProgress = false;
+			gameSession->nextLatencySample = 0;
+			gameSession->numberOfMoves = 0;
+
+			std::lock_guard<std::mutex> lock(this->gameSessionsMutex);
+			int sessionId = this->nextSessionId++;
+			this->gameSessions[sessionId] = gameSession;
+			return sessionId;
+
+		}
+
+		//End a session. A move still being computed for it finishes, but its result is not needed any more.
+		void closeSession(int sessionId) {
+
+			std::lock_guard<std::mutex> lock(this->gameSessionsMutex);
+			this->gameSessions.erase(sessionId);
+
+		}
+
+		std::size_t getNumberOfSessions() {
+
+			std::lock_guard<std::mutex> lock(this->gameSessionsMutex);
+			return this->gameSessions.size();
+
+		}
+
+		//Number of moves of sessions with the given priority that are waiting or being computed
+		std::size_t getQueueDepth(SessionPriority priority) const {
+
+			return this->queueDepths[static_cast<int>(priority)].load();
+
+		}
+
+		//Moves are turned away once this many moves of the same priority are waiting or being computed
+		void setMaximumQueueDepth(std::size_t maximumQueueDepth) {
+
+			this->maximumQueueDepth.store(maximumQueueDepth);
+
+		}
+
+		//Hand a user move to the session. The computer reply is computed in the arena of the session and delivered through
+		//the future. Returns false without queueing the move if the session is still busy with its last move or its arena
+		//has too many moves waiting.
+		bool submitUserMove(int sessionId, int dropInColumn, std::future<SessionMoveResult>& moveResult) {
+
+			std::chrono::steady_clock::time_point submitTime = std::chrono::steady_clock::now();
+			std::shared_ptr<GameSession> gameSession = getGameSession(sessionId);
+			int priorityIndex = static_cast<int>(gameSession->priority);
+
+			{
+				std::lock_guard<std::mutex> lock(gameSession->sessionMutex);
+				if (gameSession->isMoveInProgress) {
+					return false;
+				}
+
+				//Admit the move only if the queue of its arena has room
+				std::size_t queueDepth = this->queueDepths[priorityIndex].load();
+				do {
+					if (queueDepth >= this->maximumQueueDepth.load()) {
+						return false;
+					}
+				} while (!this->queueDepths[priorityIndex].compare_exchange_weak(queueDepth, queueDepth + 1));
+
+				gameSession->isMoveInProgress = true;
+			}
+
+			std::shared_ptr<std::promise<SessionMoveResult>> movePromise(new std::promise<SessionMoveResult>());
+			moveResult = movePromise->get_future();
+			this->taskArenas[priorityIndex]->enqueue([this, gameSession, dropInColumn, submitTime, movePromise]() {
+				playUserMove(gameSession, dropInColumn, submitTime, movePromise);
+			});
+
+			return true;
+
+		}
+
+		//Latency percentiles over the last moves of the session
+		LatencyPercentiles getLatencyPercentiles(int sessionId) {
+
+			std::shared_ptr<GameSession> gameSession = getGameSession(sessionId);
+			std::vector<std::chrono::microseconds> latencySamples;
+			LatencyPercentiles latencyPercentiles;
+			{
+				std::lock_guard<std::mutex> lock(gameSession->sessionMutex);
+				latencySamples = gameSession->latencySamples;
+				latencyPercentiles.numberOfMoves = gameSession->numberOfMoves;
+			}
+
+			if (latencySamples.empty()) {
+				latencyPercentiles.median = latencyPercentiles.ninetiethPercentile = latencyPercentiles.ninetyNinthPercentile = latencyPercentiles.maximum = std::chrono::microseconds::zero();
+				return latencyPercentiles;
+			}
+
+			std::sort(latencySamples.begin(), latencySamples.end());
+			std::size_t lastSample = latencySamples.size() - 1;
+			latencyPercentiles.median = latencySamples[lastSample * 50 / 100];
+			latencyPercentiles.ninetiethPercentile = latencySamples[lastSample * 90 / 100];
+			latencyPercentiles.ninetyNinthPercentile = latencySamples[lastSample * 99 / 100];
+			latencyPercentiles.maximum = latencySamples[lastSample];
+			return latencyPercentiles;
+
+		}
+
+	};
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <climits>
+#include <sstream>
+#include <stdexcept>
+
+namespace controller {
+
+	//Scores of the windows that hold one, two or three coins of a player and none of the opponent
+	struct HeuristicWeights {
+		int oneInRow;
+		int twoInRow;
+		int threeInRow;
+	};
+
+	//Scores four-in-a-row windows. A window with no opponent coins scores more the more coins of the player it holds,
+	//and a window filled by the player wins outright. The scores of the other windows are weights that can be tuned.
+	class HeuristicScorer {
+
+	private:
+
+		//Constants
+		const static int HEURISTIC_SCORE_FOR_ONE_IN_ROW = 1;
+		const static int HEURISTIC_SCORE_FOR_TWO_IN_ROW = 3;
+		const static int HEURISTIC_SCORE_FOR_THREE_IN_ROW = 9;
+		const static int HEURISTIC_SCORE_FOR_FOUR_IN_ROW = INT_MAX;
+
+		//Members
+		HeuristicWeights heuristicWeights;
+
+	public:
+
+		//Largest weight a window can have. Every window of the largest board scored at it still adds up to far less than
+		//the winning score.
+		const static int MAXIMUM_WEIGHT = 1000000;
+
+		//Number of coins in a row needed to win
+		const static int COINS_IN_A_ROW_TO_WIN = 4;
+
+		//Score for a winning move. Losing scores are the negative of it.
+		const static int WINNING_SCORE = HEURISTIC_SCORE_FOR_FOUR_IN_ROW;
+
+		HeuristicScorer() {
+
+			this->heuristicWeights = getDefaultWeights();
+
+		}
+
+		explicit HeuristicScorer(const HeuristicWeights& heuristicWeights) {
+
+			if (heuristicWeights.oneInRow < 0 || heuristicWeights.twoInRow < 0 || heuristicWeights.threeInRow < 0 ||
+				heuristicWeights.oneInRow > MAXIMUM_WEIGHT || heuristicWeights.twoInRow > MAXIMUM_WEIGHT || heuristicWeights.threeInRow > MAXIMUM_WEIGHT) {
+				std::stringstream errorMessage;
+				errorMessage << "Heuristic weights " << heuristicWeights.oneInRow << ", " << heuristicWeights.twoInRow << " and " << heuristicWeights.threeInRow <<
+					" must be between 0 and " << MAXIMUM_WEIGHT << ".";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			this->heuristicWeights = heuristicWeights;
+
+		}
+
+		//Weights the game has always played with
+		static HeuristicWeights getDefaultWeights() {
+
+			HeuristicWeights heuristicWeights;
+			heuristicWeights.oneInRow = HEURISTIC_SCORE_FOR_ONE_IN_ROW;
+			heuristicWeights.twoInRow = HEURISTIC_SCORE_FOR_TWO_IN_ROW;
+			heuristicWeights.threeInRow = HEURISTIC_SCORE_FOR_THREE_IN_ROW;
+			return heuristicWeights;
+
+		}
+
+		HeuristicWeights getWeights() const {
+
+			return this->heuristicWeights;
+
+		}
+
+		//Score for a window holding the given number of coins of a player and none of the opponent
+		int getWindowScore(int coinCount) const {
+
+			if (coinCount == 1) {
+				return this->heuristicWeights.oneInRow;
+			}
+			else if (coinCount == 2) {
+				return this->heuristicWeights.twoInRow;
+			}
+			else if (coinCount == 3) {
+				return this->heuristicWeights.threeInRow;
+			}
+			else if (coinCount == 4) {
+				return HEURISTIC_SCORE_FOR_FOUR_IN_ROW;
+			}
+			else {
+				return 0;
+			}
+		}
+
+		//Score for a window of a game played to the given number of coins in a row. The window scores as if it were a
+		//four-in-a-row window short of the same number of coins, so only the windows one to three coins short of a win
+		//score.
+		int getWindowScore(int coinCount, int winLength) const {
+
+			return getWindowScore(coinCount + COINS_IN_A_ROW_TO_WIN - winLength);
+		}
+
+		//Subtract the opponent score from the score for a move. Winning and losing scores are kept at INT_MAX and -INT_MAX
+		//so that the difference does not overflow.
+		static int subtractHeuristicScores(int moveScore, int opponentScore) {
+
+			long long scoreDifference = static_cast<long long>(moveScore) - opponentScore;
+			if (scoreDifference >= INT_MAX) {
+				return INT_MAX;
+			}
+			else if (scoreDifference <= -1 * INT_MAX) {
+				return -1 * INT_MAX;
+			}
+			else {
+				return static_cast<int>(scoreDifference);
+			}
+		}
+
+	};
+
+}
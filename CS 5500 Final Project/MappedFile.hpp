@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace controller {
+
+	//Whole file mapped read-only into memory, so that the records in it are read in place without copying them out.
+	//The mapping lasts as long as the object.
+	class MappedFile {
+
+	private:
+
+		//Members
+		const unsigned char* mappedData;
+		std::size_t mappedSize;
+#ifdef _WIN32
+		HANDLE fileHandle;
+		HANDLE mappingHandle;
+#endif
+
+		void unmap() {
+
+#ifdef _WIN32
+			if (this->mappedData != nullptr) {
+				UnmapViewOfFile(this->mappedData);
+			}
+			if (this->mappingHandle != nullptr) {
+				CloseHandle(this->mappingHandle);
+			}
+			CloseHandle(this->fileHandle);
+#else
+			if (this->mappedData != nullptr) {
+				munmap(const_cast<unsigned char*>(this->mappedData), this->mappedSize);
+			}
+#endif
+			this->mappedData = nullptr;
+
+		}
+
+	public:
+
+		//Throw the error for a file that cannot be read. The description says what kind of file it is, like "opening book".
+		[[noreturn]] static void throwFileError(const char* fileDescription, const std::string& filePath, const char* problem) {
+
+			std::stringstream errorMessage;
+			errorMessage << "Cannot read " << fileDescription << " " << filePath << ": " << problem << ".";
+			throw std::runtime_error(errorMessage.str());
+
+		}
+
+		//Map the whole file. An empty file cannot be mapped.
+		MappedFile(const std::string& filePath, const char* fileDescription) {
+
+			this->mappedData = nullptr;
+			this->mappedSize = 0;
+
+#ifdef _WIN32
+			this->fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (this->fileHandle == INVALID_HANDLE_VALUE) {
+				throwFileError(fileDescription, filePath, "the file cannot be opened");
+			}
+
+			LARGE_INTEGER fileSize;
+			GetFileSizeEx(this->fileHandle, &fileSize);
+			this->mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+			this->mappingHandle = this->mappedSize == 0 ? nullptr : CreateFileMappingA(this->fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (this->mappingHandle != nullptr) {
+				this->mappedData = static_cast<const unsigned char*>(MapViewOfFile(this->mappingHandle, FILE_MAP_READ, 0, 0, 0));
+			}
+			if (this->mappedData == nullptr) {
+				unmap();
+				throwFileError(fileDescription, filePath, "the file cannot be mapped");
+			}
+#else
+			int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+			if (fileDescriptor < 0) {
+				throwFileError(fileDescription, filePath, "the file cannot be opened");
+			}
+
+			struct stat fileStatus;
+			if (fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0) {
+				this->mappedSize = static_cast<std::size_t>(fileStatus.st_size);
+				void* mapping = mmap(nullptr, this->mappedSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+				if (mapping != MAP_FAILED) {
+					this->mappedData = static_cast<const unsigned char*>(mapping);
+				}
+			}
+
+			//The mapping stays valid after the file is closed
+			::close(fileDescriptor);
+			if (this->mappedData == nullptr) {
+				throwFileError(fileDescription, filePath, "the file cannot be mapped");
+			}
+#endif
+
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile() {
+
+			unmap();
+
+		}
+
+		const unsigned char* getData() const {
+
+			return this->mappedData;
+
+		}
+
+		std::size_t getSize() const {
+
+			return this->mappedSize;
+
+		}
+
+	};
+
+	//File mapped read-write and shared with every process that maps it, so that what one process writes into the
+	//mapping is seen by the others and ends up in the file. A missing file is created at the given size. The file is
+	//locked while the caller sets up a new file or checks an existing one, so that two processes opening it at once do
+	//not both set it up. The mapping lasts as long as the object.
+	class SharedMappedFile {
+
+	private:
+
+		//Members
+		unsigned char* mappedData;
+		std::size_t mappedSize;
+#ifdef _WIN32
+		HANDLE fileHandle;
+		HANDLE mappingHandle;
+#endif
+
+		void unmap() {
+
+#ifdef _WIN32
+			if (this->mappedData != nullptr) {
+				UnmapViewOfFile(this->mappedData);
+			}
+			if (this->mappingHandle != nullptr) {
+				CloseHandle(this->mappingHandle);
+			}
+			CloseHandle(this->fileHandle);
+#else
+			if (this->mappedData != nullptr) {
+				munmap(this->mappedData, this->mappedSize);
+			}
+#endif
+			this->mappedData = nullptr;
+
+		}
+
+	public:
+
+		//Map the file, creating it at the given size if it is missing or empty. The set up function is called with the
+		//mapped data, its size and whether the file was just created, while no other process can open the file. It
+		//writes the start of a new file or throws if an existing one does not fit.
+		SharedMappedFile(const std::string& filePath, const char* fileDescription, std::size_t newFileSize,
+			std::function<void(unsigned char*, std::size_t, bool)> setUpFile) {
+
+			this->mappedData = nullptr;
+			this->mappedSize = 0;
+			bool isNewFile = false;
+
+#ifdef _WIN32
+			this->mappingHandle = nullptr;
+			this->fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (this->fileHandle == INVALID_HANDLE_VALUE) {
+				MappedFile::throwFileError(fileDescription, filePath, "the file cannot be opened");
+			}
+
+			OVERLAPPED lockRange = {};
+			LockFileEx(this->fileHandle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &lockRange);
+
+			LARGE_INTEGER fileSize;
+			GetFileSizeEx(this->fileHandle, &fileSize);
+			if (fileSize.QuadPart == 0) {
+				fileSize.QuadPart = static_cast<LONGLONG>(newFileSize);
+				SetFilePointerEx(this->fileHandle, fileSize, nullptr, FILE_BEGIN);
+				SetEndOfFile(this->fileHandle);
+				isNewFile = true;
+			}
+			this->mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+
+			this->mappingHandle = this->mappedSize == 0 ? nullptr : CreateFileMappingA(this->fileHandle, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+			if (this->mappingHandle != nullptr) {
+				this->mappedData = static_cast<unsigned char*>(MapViewOfFile(this->mappingHandle, FILE_MAP_WRITE, 0, 0, 0));
+			}
+			if (this->mappedData == nullptr) {
+				UnlockFileEx(this->fileHandle, 0, MAXDWORD, MAXDWORD, &lockRange);
+				unmap();
+				MappedFile::throwFileError(fileDescription, filePath, "the file cannot be mapped");
+			}
+
+			try {
+				setUpFile(this->mappedData, this->mappedSize, isNewFile);
+			}
+			catch (...) {
+				UnlockFileEx(this->fileHandle, 0, MAXDWORD, MAXDWORD, &lockRange);
+				unmap();
+				throw;
+			}
+			UnlockFileEx(this->fileHandle, 0, MAXDWORD, MAXDWORD, &lockRange);
+#else
+			int fileDescriptor = ::open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+			if (fileDescriptor < 0) {
+				MappedFile::throwFileError(fileDescription, filePath, "the file cannot be opened");
+			}
+
+			//Closing the file also gives up the lock
+			flock(fileDescriptor, LOCK_EX);
+
+			struct stat fileStatus;
+			if (fstat(fileDescriptor, &fileStatus) == 0) {
+				if (fileStatus.st_size == 0 && ftruncate(fileDescriptor, static_cast<off_t>(newFileSize)) == 0) {
+					fileStatus.st_size = static_cast<off_t>(newFileSize);
+					isNewFile = true;
+				}
+				this->mappedSize = static_cast<std::size_t>(fileStatus.st_size);
+			}
+			if (this->mappedSize > 0) {
+				void* mapping = mmap(nullptr, this->mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+				if (mapping != MAP_FAILED) {
+					this->mappedData = static_cast<unsigned char*>(mapping);
+				}
+			}
+			if (this->mappedData == nullptr) {
+				::close(fileDescriptor);
+				MappedFile::throwFileError(fileDescription, filePath, "the file cannot be mapped");
+			}
+
+			try {
+				setUpFile(this->mappedData, this->mappedSize, isNewFile);
+			}
+			catch (...) {
+				::close(fileDescriptor);
+				unmap();
+				throw;
+			}
+
+			//The mapping stays valid after the file is closed
+			::close(fileDescriptor);
+#endif
+
+		}
+
+		SharedMappedFile(const SharedMappedFile&) = delete;
+		SharedMappedFile& operator=(const SharedMappedFile&) = delete;
+
+		~SharedMappedFile() {
+
+			unmap();
+
+		}
+
+		unsigned char* getData() const {
+
+			return this->mappedData;
+
+		}
+
+		std::size_t getSize() const {
+
+			return this->mappedSize;
+
+		}
+
+	};
+
+}
@@ -0,0 +1,478 @@
+#pragma once
+
+#include <tbb\task_arena.h>
+#include <tbb\task_group.h>
+
+#include "GameBoard.hpp"
+#include "SearchControl.hpp"
+#include "SearchResult.hpp"
+#include "SearchStats.hpp"
+#include "ThreatFilter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace controller {
+
+	//How the playouts pick their moves. Random playouts play any column. Playouts with wins and blocks take a winning
+	//move when there is one and otherwise block the opponent win, which makes them slower but much closer to real play.
+	enum class PlayoutPolicy { random, winsAndBlocks };
+
+	//Monte Carlo tree search for a board of any size. Searches are made by create, which picks a search compiled for the
+	//size of the board when there is one and otherwise falls back to the search for boards sized at run time.
+	class MonteCarloTreeSearch {
+
+	public:
+
+		virtual ~MonteCarloTreeSearch() {
+		}
+
+		virtual void setPlayoutPolicy(PlayoutPolicy playoutPolicy) = 0;
+
+		//Let the searches that follow be cancelled and polled through the control. Null searches without one.
+		virtual void setSearchControl(SearchControl* searchControl) = 0;
+
+		//Find the best move for the player to move with the given number of playouts
+		virtual SearchResult search(const model::GameBoard& gameBoard, int numberOfPlayouts, bool isUserCoin) = 0;
+
+		//Find the best move for the player to move with as many playouts as fit into the time budget
+		virtual SearchResult searchWithTimeBudget(const model::GameBoard& gameBoard, std::chrono::steady_clock::duration moveTimeBudget, bool isUserCoin) = 0;
+
+		//Search on the board type that suits the board, see model::createForBoardType
+		static std::unique_ptr<MonteCarloTreeSearch> create(int numberOfRows, int numberOfColumns, int winLength);
+
+	};
+
+	//Node of the search tree for the move that led to it. The playout results are counted for the player who made the
+	//move, two for a win and one for a draw. The children are allocated together when the node is expanded and are
+	//published to the other threads by the expansion state.
+	struct MonteCarloTreeNode {
+		std::atomic<std::uint32_t> visits;
+		std::atomic<std::uint32_t> rewards;
+		std::atomic<std::uint8_t> expansionState;
+		std::uint8_t numberOfChildren;
+		std::int8_t move;
+		std::int8_t outcome;
+		std::uint32_t firstChild;
+	};
+
+	//Arena the tree nodes are allocated from. The nodes are allocated once and handed out in blocks by bumping an atomic
+	//index, so expanding a node takes no lock and no call to the heap. Resetting the arena frees every node at once.
+	class MonteCarloTreeNodePool {
+
+	private:
+
+		//Members
+		std::unique_ptr<MonteCarloTreeNode[]> nodes;
+		std::uint32_t numberOfNodes;
+		std::atomic<std::uint32_t> numberOfNodesUsed;
+
+	public:
+
+		const static std::uint32_t NO_NODE = 0xFFFFFFFF;
+
+		explicit MonteCarloTreeNodePool(std::uint32_t numberOfNodes) : nodes(new MonteCarloTreeNode[numberOfNodes]), numberOfNodes(numberOfNodes), numberOfNodesUsed(0) {
+		}
+
+		//Hand out a block of nodes and return the index of the first one, or NO_NODE once the arena is full. The nodes are
+		//not cleared.
+		std::uint32_t allocate(int numberOfNodesToAllocate) {
+
+			//Check first so that a full arena does not keep pushing the index up
+			if (this->numberOfNodesUsed.load(std::memory_order_relaxed) + numberOfNodesToAllocate > this->numberOfNodes) {
+				return NO_NODE;
+			}
+
+			std::uint32_t firstNode = this->numberOfNodesUsed.fetch_add(numberOfNodesToAllocate);
+			if (firstNode + numberOfNodesToAllocate > this->numberOfNodes) {
+				return NO_NODE;
+			}
+
+			return firstNode;
+		}
+
+		MonteCarloTreeNode& at(std::uint32_t nodeIndex) {
+
+			return this->nodes[nodeIndex];
+		}
+
+		std::uint32_t getNumberOfNodesUsed() const {
+
+			return std::min(this->numberOfNodesUsed.load(), this->numberOfNodes);
+		}
+
+		void reset() {
+
+			this->numberOfNodesUsed.store(0);
+		}
+
+	};
+
+	//Monte Carlo tree search with UCT selection. Each playout walks down the tree picking the child with the best upper
+	//confidence bound, expands the node it stops at once that node has been visited, plays the game out to the end and
+	//counts the result back up the path. All the threads of the arena grow the same tree without locks. A thread counts
+	//its visit to a node on the way down and its result only on the way back up, so until then the node looks like a
+	//lost playout to the other threads (virtual loss) and they spread out over other moves.
+	//The best move is the one played the most. Its score is the share of its playouts won, in percent, counting draws as
+	//half a win, and the depth is the deepest node of the tree.
+	//The search runs on copies of the board in the board type it is compiled for.
+	template <typename GameBoardType>
+	class BasicMonteCarloTreeSearch : public MonteCarloTreeSearch {
+
+	private:
+
+		enum class ExpansionState : std::uint8_t { leaf, expanding, expanded };
+
+		//Outcome of a move for the player who made it. A node keeps it when the move ends the game and none otherwise.
+		enum class MoveOutcome : std::int8_t { none, win, draw, loss };
+
+		//Random number generator of one thread (xorshift64*)
+		struct PlayoutRandom {
+			std::uint64_t state;
+
+			int nextColumn(int numberOfColumns) {
+				this->state ^= this->state >> 12;
+				this->state ^= this->state << 25;
+				this->state ^= this->state >> 27;
+				return static_cast<int>(((this->state * 0x2545F4914F6CDD1DULL) >> 32) % static_cast<std::uint64_t>(numberOfColumns));
+			}
+		};
+
+		//Constants
+		constexpr static double EXPLORATION_CONSTANT = 1.0;
+		const static std::uint32_t NUMBER_OF_NODES = 1 << 20;
+		const static std::uint32_t VISITS_BEFORE_EXPANSION = 2;
+		const static std::uint32_t REWARD_FOR_WIN = 2;
+		const static std::uint32_t REWARD_FOR_DRAW = 1;
+		const static int PLAYOUTS_BETWEEN_PROGRESS_REPORTS = 4096;
+		const static std::uint32_t ROOT_NODE = 0;
+		const static std::uint64_t RANDOM_SEED = 0x9E3779B97F4A7C15ULL;
+
+		//Members
+		MonteCarloTreeNodePool nodePool;
+		PlayoutPolicy playoutPolicy;
+		SearchControl* searchControl;
+		SearchStatsCounters searchStatsCounters;
+		std::atomic<int> playoutsStarted;
+		std::atomic<int> maximumTreeDepth;
+		int numberOfPlayouts;
+		bool hasDeadline;
+		std::chrono::steady_clock::time_point deadline;
+
+		bool isSearchStopped() const {
+
+			return this->searchControl != nullptr && this->searchControl->isCancelled();
+
+		}
+
+		void initializeNode(MonteCarloTreeNode& node, int move, MoveOutcome outcome) {
+
+			node.visits.store(0, std::memory_order_relaxed);
+			node.rewards.store(0, std::memory_order_relaxed);
+			node.expansionState.store(static_cast<std::uint8_t>(ExpansionState::leaf), std::memory_order_relaxed);
+			node.numberOfChildren = 0;
+			node.move = static_cast<std::int8_t>(move);
+			node.outcome = static_cast<std::int8_t>(outcome);
+			node.firstChild = MonteCarloTreeNodePool::NO_NODE;
+
+		}
+
+		//Give the node a child for every move the threat filter leaves, so a winning move is the only child when there is
+		//one and a forced block the only child when the opponent threatens to win. Moves that are the mirror image of a
+		//move further left are left out. Only the thread that wins the race expands the node, and it leaves the node a leaf
+		//if the arena is full.
+		void expandNode(MonteCarloTreeNode& node, const GameBoardType& gameBoard, bool isUserCoin) {
+
+			std::uint8_t leafState = static_cast<std::uint8_t>(ExpansionState::leaf);
+			if (!node.expansionState.compare_exchange_strong(leafState, static_cast<std::uint8_t>(ExpansionState::expanding))) {
+				return;
+			}
+
+			int moves[GameBoardType::MAXIMUM_NUMBER_OF_COLUMNS];
+			MoveOutcome outcomes[GameBoardType::MAXIMUM_NUMBER_OF_COLUMNS];
+			int numberOfMoves = 0;
+			bool isLastSlot = gameBoard.getNumberOfCoins() + 1 == gameBoard.getNumberOfRows() * gameBoard.getNumberOfColumns();
+			ThreatFilterResult threatFilterResult = ThreatFilter::filterMoves(gameBoard, isUserCoin, 2);
+			if (threatFilterResult.outcome == ThreatOutcome::win) {
+				moves[numberOfMoves] = ThreatFilter::getFirstColumn(threatFilterResult.columns);
+				outcomes[numberOfMoves] = MoveOutcome::win;
+				++numberOfMoves;
+			}
+			else {
+				for (int columnCounter = 0; columnCounter < gameBoard.getNumberOfColumns(); ++columnCounter) {
+					if (ThreatFilter::containsColumn(threatFilterResult.columns, columnCounter) && gameBoard.canDropCoin(columnCounter) && !gameBoard.isMirrorOfEarlierMove(columnCounter)) {
+						moves[numberOfMoves] = columnCounter;
+						outcomes[numberOfMoves] = isLastSlot ? MoveOutcome::draw : MoveOutcome::none;
+						++numberOfMoves;
+					}
+				}
+			}
+
+			std::uint32_t firstChild = this->nodePool.allocate(numberOfMoves);
+			if (firstChild == MonteCarloTreeNodePool::NO_NODE) {
+				node.expansionState.store(static_cast<std::uint8_t>(ExpansionState::leaf), std::memory_order_release);
+				return;
+			}
+
+			for (int moveCounter = 0; moveCounter < numberOfMoves; ++moveCounter) {
+				initializeNode(this->nodePool.at(firstChild + moveCounter), moves[moveCounter], outcomes[moveCounter]);
+			}
+			node.firstChild = firstChild;
+			node.numberOfChildren = static_cast<std::uint8_t>(numberOfMoves);
+			node.expansionState.store(static_cast<std::uint8_t>(ExpansionState::expanded), std::memory_order_release);
+
+		}
+
+		//Pick the child with the best upper confidence bound. A child nobody has visited yet is picked right away.
+		MonteCarloTreeNode& selectChild(MonteCarloTreeNode& node) {
+
+			double logParentVisits = std::log(static_cast<double>(std::max<std::uint32_t>(node.visits.load(std::memory_order_relaxed), 1)));
+			MonteCarloTreeNode* bestChild = nullptr;
+			double bestBound = -1.0;
+			for (int childCounter = 0; childCounter < node.numberOfChildren; ++childCounter) {
+
+				MonteCarloTreeNode& child = this->nodePool.at(node.firstChild + childCounter);
+				std::uint32_t visits = child.visits.load(std::memory_order_relaxed);
+				if (visits == 0) {
+					return child;
+				}
+
+				double bound = child.rewards.load(std::memory_order_relaxed) / (static_cast<double>(REWARD_FOR_WIN) * visits) +
+					EXPLORATION_CONSTANT * std::sqrt(logParentVisits / visits);
+				if (bound > bestBound) {
+					bestBound = bound;
+					bestChild = &child;
+				}
+			}
+
+			return *bestChild;
+		}
+
+		//Play random moves until the game is over. Returns the outcome for the player who made the last move before the
+		//playout, which is the opposite of the player to move.
+		MoveOutcome playOut(GameBoardType& gameBoard, bool isUserCoin, PlayoutRandom& playoutRandom) {
+
+			bool isUserCoinToMove = isUserCoin;
+			while (!gameBoard.isFull()) {
+
+				int columnPlayed = -1;
+				if (this->playoutPolicy == PlayoutPolicy::winsAndBlocks) {
+					for (int columnCounter = 0; columnCounter < gameBoard.getNumberOfColumns(); ++columnCounter) {
+						if (gameBoard.canDropCoin(columnCounter)) {
+							if (gameBoard.isWinningDrop(columnCounter, isUserCoinToMove)) {
+								return isUserCoinToMove == isUserCoin ? MoveOutcome::loss : MoveOutcome::win;
+							}
+							if (columnPlayed == -1 && gameBoard.isWinningDrop(columnCounter, isUserCoinToMove ? false : true)) {
+								columnPlayed = columnCounter;
+							}
+						}
+					}
+				}
+
+				if (columnPlayed == -1) {
+					do {
+						columnPlayed = playoutRandom.nextColumn(gameBoard.getNumberOfColumns());
+					} while (!gameBoard.canDropCoin(columnPlayed));
+
+					if (gameBoard.isWinningDrop(columnPlayed, isUserCoinToMove)) {
+						return isUserCoinToMove == isUserCoin ? MoveOutcome::loss : MoveOutcome::win;
+					}
+				}
+
+				gameBoard.dropCoinUnchecked(columnPlayed, isUserCoinToMove);
+				isUserCoinToMove = isUserCoinToMove ? false : true;
+			}
+
+			return MoveOutcome::draw;
+		}
+
+		//Run one playout from the root: select down the tree, expand, play out and count the result back up the path
+		void runPlayout(const GameBoardType& rootGameBoard, bool isUserCoin, PlayoutRandom& playoutRandom, int& maximumDepth) {
+
+			MonteCarloTreeNode* path[GameBoardType::MAXIMUM_NUMBER_OF_SLOTS + 1];
+			int pathLength = 0;
+
+			GameBoardType gameBoard = rootGameBoard;
+			bool isUserCoinToMove = isUserCoin;
+			MonteCarloTreeNode* node = &this->nodePool.at(ROOT_NODE);
+			node->visits.fetch_add(1, std::memory_order_relaxed);
+			path[pathLength++] = node;
+
+			while (static_cast<MoveOutcome>(node->outcome) == MoveOutcome::none &&
+				node->expansionState.load(std::memory_order_acquire) == static_cast<std::uint8_t>(ExpansionState::expanded)) {
+
+				node = &selectChild(*node);
+				node->visits.fetch_add(1, std::memory_order_relaxed);
+				path[pathLength++] = node;
+				gameBoard.dropCoinUnchecked(node->move, isUserCoinToMove);
+				isUserCoinToMove = isUserCoinToMove ? false : true;
+			}
+
+			//The outcome is for the player who made the move into the node the playout stopped at
+			MoveOutcome outcome = static_cast<MoveOutcome>(node->outcome);
+			if (outcome == MoveOutcome::none) {
+				if (node->visits.load(std::memory_order_relaxed) >= VISITS_BEFORE_EXPANSION || pathLength == 1) {
+					expandNode(*node, gameBoard, isUserCoinToMove);
+				}
+				outcome = playOut(gameBoard, isUserCoinToMove, playoutRandom);
+				this->searchStatsCounters.countEvaluation();
+			}
+			else {
+				this->searchStatsCounters.countLeaf();
+			}
+			this->searchStatsCounters.countNode(pathLength - 1);
+			maximumDepth = std::max(maximumDepth, pathLength - 1);
+
+			//Going up the path the mover changes at every node, so a win for one node is a loss for its parent
+			for (int pathCounter = pathLength - 1; pathCounter >= 0; --pathCounter) {
+
+				if (outcome == MoveOutcome::win) {
+					path[pathCounter]->rewards.fetch_add(REWARD_FOR_WIN, std::memory_order_relaxed);
+					outcome = MoveOutcome::loss;
+				}
+				else if (outcome == MoveOutcome::loss) {
+					outcome = MoveOutcome::win;
+				}
+				else {
+					path[pathCounter]->rewards.fetch_add(REWARD_FOR_DRAW, std::memory_order_relaxed);
+				}
+			}
+
+		}
+
+		//Most played move at the root, or null if the root has not been expanded
+		MonteCarloTreeNode* getMostPlayedChild() {
+
+			MonteCarloTreeNode& root = this->nodePool.at(ROOT_NODE);
+			if (root.expansionState.load(std::memory_order_acquire) != static_cast<std::uint8_t>(ExpansionState::expanded)) {
+				return nullptr;
+			}
+
+			MonteCarloTreeNode* mostPlayedChild = nullptr;
+			for (int childCounter = 0; childCounter < root.numberOfChildren; ++childCounter) {
+				MonteCarloTreeNode& child = this->nodePool.at(root.firstChild + childCounter);
+				if (mostPlayedChild == nullptr || child.visits.load(std::memory_order_relaxed) > mostPlayedChild->visits.load(std::memory_order_relaxed)) {
+					mostPlayedChild = &child;
+				}
+			}
+
+			return mostPlayedChild;
+		}
+
+		//Claim playouts one at a time until the budget or the time runs out or the search is cancelled
+		void runWorker(const GameBoardType& rootGameBoard, bool isUserCoin, int workerNumber) {
+
+			PlayoutRandom playoutRandom = { RANDOM_SEED * (workerNumber + 1) };
+			int maximumDepth = 0;
+			while (!isSearchStopped()) {
+
+				int playoutNumber = this->playoutsStarted.fetch_add(1, std::memory_order_relaxed);
+				if ((!this->hasDeadline && playoutNumber >= this->numberOfPlayouts) ||
+					(this->hasDeadline && std::chrono::steady_clock::now() >= this->deadline)) {
+					break;
+				}
+
+				runPlayout(rootGameBoard, isUserCoin, playoutRandom, maximumDepth);
+
+				if (this->searchControl != nullptr && playoutNumber % PLAYOUTS_BETWEEN_PROGRESS_REPORTS == PLAYOUTS_BETWEEN_PROGRESS_REPORTS - 1) {
+					MonteCarloTreeNode* mostPlayedChild = getMostPlayedChild();
+					if (mostPlayedChild != nullptr) {
+						this->searchControl->reportProgress(mostPlayedChild->move, this->maximumTreeDepth.load());
+					}
+				}
+
+				int treeDepth = this->maximumTreeDepth.load(std::memory_order_relaxed);
+				while (maximumDepth > treeDepth && !this->maximumTreeDepth.compare_exchange_weak(treeDepth, maximumDepth)) {
+				}
+			}
+
+		}
+
+		//Grow the tree with one worker per thread of the arena and pick the most played move
+		SearchResult runSearch(const model::GameBoard& gameBoard, bool isUserCoin) {
+
+			std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+			this->searchStatsCounters.clear();
+			this->playoutsStarted.store(0);
+			this->maximumTreeDepth.store(0);
+			this->nodePool.reset();
+			initializeNode(this->nodePool.at(this->nodePool.allocate(1)), -1, MoveOutcome::none);
+
+			GameBoardType searchGameBoard(gameBoard);
+			tbb::task_group workers;
+			int numberOfWorkers = tbb::this_task_arena::max_concurrency();
+			for (int workerCounter = 0; workerCounter < numberOfWorkers; ++workerCounter) {
+				workers.run([this, &searchGameBoard, isUserCoin, workerCounter]() {
+					runWorker(searchGameBoard, isUserCoin, workerCounter);
+				});
+			}
+			{
+				SearchStatsCounters::TaskWaitTimer taskWaitTimer(this->searchStatsCounters);
+				workers.wait();
+			}
+
+			SearchResult searchResult;
+			searchResult.searchAlgorithm = SearchAlgorithm::monteCarloTreeSearch;
+			searchResult.bestMove = -1;
+			searchResult.score = 0;
+			searchResult.depth = this->maximumTreeDepth.load();
+			MonteCarloTreeNode* mostPlayedChild = getMostPlayedChild();
+			if (mostPlayedChild != nullptr && mostPlayedChild->visits.load() > 0) {
+				searchResult.bestMove = mostPlayedChild->move;
+				searchResult.score = static_cast<int>(100 * mostPlayedChild->rewards.load() / (REWARD_FOR_WIN * mostPlayedChild->visits.load()));
+			}
+			if (this->searchControl != nullptr && !isSearchStopped()) {
+				this->searchControl->reportProgress(searchResult.bestMove, searchResult.depth);
+			}
+
+			searchResult.nodes = this->nodePool.at(ROOT_NODE).visits.load();
+			searchResult.peakScratchMemory = this->nodePool.getNumberOfNodesUsed() * sizeof(MonteCarloTreeNode);
+			searchResult.searchStats = this->searchStatsCounters.getSearchStats();
+			searchResult.elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+			return searchResult;
+		}
+
+	public:
+
+		BasicMonteCarloTreeSearch() :
+			nodePool(NUMBER_OF_NODES), playoutPolicy(PlayoutPolicy::winsAndBlocks), searchControl(nullptr), playoutsStarted(0), maximumTreeDepth(0), numberOfPlayouts(0), hasDeadline(false) {
+		}
+
+		void setPlayoutPolicy(PlayoutPolicy playoutPolicy) override {
+
+			this->playoutPolicy = playoutPolicy;
+		}
+
+		void setSearchControl(SearchControl* searchControl) override {
+
+			this->searchControl = searchControl;
+		}
+
+		//Find the best move for the player to move with the given number of playouts
+		SearchResult search(const model::GameBoard& gameBoard, int numberOfPlayouts, bool isUserCoin) override {
+
+			this->numberOfPlayouts = std::max(numberOfPlayouts, 1);
+			this->hasDeadline = false;
+			return runSearch(gameBoard, isUserCoin);
+		}
+
+		//Find the best move for the player to move with as many playouts as fit into the time budget
+		SearchResult searchWithTimeBudget(const model::GameBoard& gameBoard, std::chrono::steady_clock::duration moveTimeBudget, bool isUserCoin) override {
+
+			this->hasDeadline = true;
+			this->deadline = std::chrono::steady_clock::now() + moveTimeBudget;
+			return runSearch(gameBoard, isUserCoin);
+		}
+
+	};
+
+	inline std::unique_ptr<MonteCarloTreeSearch> MonteCarloTreeSearch::create(int numberOfRows, int numberOfColumns, int winLength) {
+
+		return model::createForBoardType<MonteCarloTreeSearch, BasicMonteCarloTreeSearch>(numberOfRows, numberOfColumns, winLength);
+	}
+
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "GameBoard.hpp"
+#include "ThreatFilter.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+namespace controller {
+
+	//Stages of the move ordering that are switched on. Each one can be turned off on its own to measure how many nodes
+	//it saves.
+	struct MoveOrderingOptions {
+		bool transpositionTableMove;
+		bool killerMoves;
+		bool historyHeuristic;
+		bool centerFirst;
+	};
+
+	//Orders the moves of a position so that the ones most likely to cut the search off are tried first. The best move
+	//from an earlier search of the position comes first, then the killer moves of the ply, then the rest by their
+	//history score and distance from the center column. Killer moves and history scores are learned from the cutoffs
+	//of the whole search and are shared by all of its tasks, so they are kept in relaxed atomics. A lost update only
+	//changes the order, never the score.
+	class MoveOrdering {
+
+	private:
+
+		//Constants
+		const static int KILLER_MOVES_PER_PLY = 2;
+		const static int NUMBER_OF_PLIES = model::GameBoard::MAXIMUM_NUMBER_OF_SLOTS + 1;
+		const static int NUMBER_OF_SLOTS = model::GameBoard::MAXIMUM_NUMBER_OF_SLOTS;
+		const static std::int8_t NO_KILLER_MOVE = -1;
+
+		//Members
+		MoveOrderingOptions moveOrderingOptions;
+		std::atomic<std::int8_t> killerMoves[NUMBER_OF_PLIES][KILLER_MOVES_PER_PLY];
+		std::atomic<std::uint32_t> historyScores[2][NUMBER_OF_SLOTS];
+
+		//Check if the move can be played, is one of the allowed columns and has not been added to the list yet. On a board
+		//that is its own mirror image only the moves on the left half and in the center are listed, since the others score
+		//the same.
+		template <typename GameBoardType>
+		static bool isNewMove(const GameBoardType& gameBoard, int columnNumber, std::uint32_t allowedColumns, const int* moves, int numberOfMoves) {
+
+			if (columnNumber < 0 || !ThreatFilter::containsColumn(allowedColumns, columnNumber) || !gameBoard.canDropCoin(columnNumber) ||
+				gameBoard.isMirrorOfEarlierMove(columnNumber)) {
+				return false;
+			}
+
+			for (int moveCounter = 0; moveCounter < numberOfMoves; ++moveCounter) {
+				if (moves[moveCounter] == columnNumber) {
+					return false;
+				}
+			}
+
+			return true;
+
+		}
+
+		//Sort key of a move that is not a best or killer move. Higher keys are tried first.
+		template <typename GameBoardType>
+		std::uint64_t getMoveKey(const GameBoardType& gameBoard, int columnNumber, bool isUserCoin) const {
+
+			std::uint64_t historyScore = 0;
+			if (this->moveOrderingOptions.historyHeuristic) {
+				historyScore = this->historyScores[isUserCoin ? 1 : 0][gameBoard.getAvailableSlot(columnNumber)].load(std::memory_order_relaxed);
+			}
+
+			//Twice the distance from the center so that boards with an even number of columns have whole distances
+			int centerDistance = 0;
+			if (this->moveOrderingOptions.centerFirst) {
+				centerDistance = std::abs(2 * columnNumber - (gameBoard.getNumberOfColumns() - 1));
+			}
+
+			return (historyScore << 8) | static_cast<std::uint64_t>(0xFF - centerDistance);
+
+		}
+
+	public:
+
+		//All stages are switched on by default
+		MoveOrdering() {
+
+			MoveOrderingOptions moveOrderingOptions;
+			moveOrderingOptions.transpositionTableMove = true;
+			moveOrderingOptions.killerMoves = true;
+			moveOrderingOptions.historyHeuristic = true;
+			moveOrderingOptions.centerFirst = true;
+			setOptions(moveOrderingOptions);
+			clear();
+
+		}
+
+		MoveOrdering(const MoveOrdering&) = delete;
+		MoveOrdering& operator=(const MoveOrdering&) = delete;
+
+		MoveOrderingOptions getOptions() const {
+
+			return this->moveOrderingOptions;
+
+		}
+
+		void setOptions(MoveOrderingOptions moveOrderingOptions) {
+
+			this->moveOrderingOptions = moveOrderingOptions;
+
+		}
+
+		//Forget the killer moves and history scores. Must not be called while a search is using them.
+		void clear() {
+
+			for (int plyCounter = 0; plyCounter < NUMBER_OF_PLIES; ++plyCounter) {
+				for (int killerCounter = 0; killerCounter < KILLER_MOVES_PER_PLY; ++killerCounter) {
+					this->killerMoves[plyCounter][killerCounter].store(NO_KILLER_MOVE, std::memory_order_relaxed);
+				}
+			}
+
+			for (int playerCounter = 0; playerCounter < 2; ++playerCounter) {
+				for (int slotCounter = 0; slotCounter < NUMBER_OF_SLOTS; ++slotCounter) {
+					this->historyScores[playerCounter][slotCounter].store(0, std::memory_order_relaxed);
+				}
+			}
+
+		}
+
+		//Fill in the moves that can be played in the order they should be searched and return how many there are. Only the
+		//allowed columns are listed, such as the ones left by the threat filter. The ply is the number of coins on the
+		//board, so killer moves stay with the same position across deeper searches.
+		template <typename GameBoardType>
+		int orderMoves(const GameBoardType& gameBoard, bool isUserCoin, int preferredMove, int transpositionTableMove, int* moves,
+			std::uint32_t allowedColumns = ThreatFilter::ALL_COLUMNS) const {
+
+			int numberOfMoves = 0;
+
+			if (this->moveOrderingOptions.transpositionTableMove) {
+				if (isNewMove(gameBoard, preferredMove, allowedColumns, moves, numberOfMoves)) {
+					moves[numberOfMoves++] = preferredMove;
+				}
+				if (isNewMove(gameBoard, transpositionTableMove, allowedColumns, moves, numberOfMoves)) {
+					moves[numberOfMoves++] = transpositionTableMove;
+				}
+			}
+
+			if (this->moveOrderingOptions.killerMoves) {
+				int ply = gameBoard.getNumberOfCoins();
+				for (int killerCounter = 0; killerCounter < KILLER_MOVES_PER_PLY; ++killerCounter) {
+					int killerMove = this->killerMoves[ply][killerCounter].load(std::memory_order_relaxed);
+					if (isNewMove(gameBoard, killerMove, allowedColumns, moves, numberOfMoves)) {
+						moves[numberOfMoves++] = killerMove;
+					}
+				}
+			}
+
+			//Insert the remaining moves by their keys. Equal keys keep index order.
+			int firstSortedMove = numberOfMoves;
+			std::uint64_t moveKeys[GameBoardType::MAXIMUM_NUMBER_OF_COLUMNS];
+			for (int columnCounter = 0; columnCounter < gameBoard.getNumberOfColumns(); ++columnCounter) {
+
+				if (!isNewMove(gameBoard, columnCounter, allowedColumns, moves, firstSortedMove)) {
+					continue;
+				}
+
+				std::uint64_t moveKey = getMoveKey(gameBoard, columnCounter, isUserCoin);
+				int insertAt = numberOfMoves;
+				while (insertAt > firstSortedMove && moveKeys[insertAt - 1] < moveKey) {
+					moves[insertAt] = moves[insertAt - 1];
+					moveKeys[insertAt] = moveKeys[insertAt - 1];
+					--insertAt;
+				}
+				moves[insertAt] = columnCounter;
+				moveKeys[insertAt] = moveKey;
+				++numberOfMoves;
+			}
+
+			return numberOfMoves;
+
+		}
+
+		//Learn from a move that cut the search off. The move becomes the newest killer move of the ply and its history
+		//score grows with the square of the depth searched below it.
+		template <typename GameBoardType>
+		void recordCutoff(const GameBoardType& gameBoard, int columnNumber, bool isUserCoin, int depth) {
+
+			if (this->moveOrderingOptions.killerMoves) {
+				int ply = gameBoard.getNumberOfCoins();
+				if (this->killerMoves[ply][0].load(std::memory_order_relaxed) != columnNumber) {
+					this->killerMoves[ply][1].store(this->killerMoves[ply][0].load(std::memory_order_relaxed), std::memory_order_relaxed);
+					this->killerMoves[ply][0].store(static_cast<std::int8_t>(columnNumber), std::memory_order_relaxed);
+				}
+			}
+
+			if (this->moveOrderingOptions.historyHeuristic) {
+				this->historyScores[isUserCoin ? 1 : 0][gameBoard.getAvailableSlot(columnNumber)].fetch_add(depth * depth, std::memory_order_relaxed);
+			}
+
+		}
+
+	};
+
+}
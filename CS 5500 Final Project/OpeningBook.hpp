@@ -0,0 +1,175 @@
+#pragma once
+
+#include "GameBoard.hpp"
+#include "MappedFile.hpp"
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace controller {
+
+	//Best move found for a book position by a deep offline search
+	struct OpeningBookEntry {
+		std::uint64_t key;
+		std::int32_t score;
+		std::uint8_t depth;
+		std::int8_t bestMove;
+		std::uint8_t reserved[2];
+	};
+
+	//Start of a book file. The entries follow it sorted by key.
+	struct OpeningBookHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint8_t numberOfRows;
+		std::uint8_t numberOfColumns;
+		std::uint8_t reserved[2];
+		std::uint64_t numberOfEntries;
+		std::uint64_t reserved2;
+	};
+
+	static_assert(sizeof(OpeningBookEntry) == 16, "Book entries are written to the file as they are laid out in memory.");
+	static_assert(sizeof(OpeningBookHeader) == 32, "The book header is written to the file as it is laid out in memory.");
+
+	//Opening book built offline by BuildOpeningBook and mapped read-only into memory. The file is the header followed by
+	//the entries sorted by position key, stored in the byte order of the machine, so a lookup is a binary search
+	//straight over the mapped file with nothing to parse at startup. Positions are keyed like the transposition table,
+	//by the canonical board hash and the player to move, so a position and its mirror image share one entry whose best
+	//move is saved for the canonical board. Each file is mapped once per process and shared by every game that uses it.
+	class OpeningBook {
+
+	private:
+
+		//Constants
+		const static std::uint32_t FILE_VERSION = 2;
+
+		//Members
+		MappedFile mappedFile;
+		const OpeningBookHeader* header;
+		const OpeningBookEntry* entries;
+
+		static const char* getMagic() {
+
+			return "C4BOOK\0\0";
+
+		}
+
+		static void throwFileError(const std::string& filePath, const char* problem) {
+
+			MappedFile::throwFileError("opening book", filePath, problem);
+
+		}
+
+		//Map the whole file and check that the header matches its size
+		explicit OpeningBook(const std::string& filePath) : mappedFile(filePath, "opening book") {
+
+			std::size_t mappedSize = this->mappedFile.getSize();
+			this->header = reinterpret_cast<const OpeningBookHeader*>(this->mappedFile.getData());
+			this->entries = reinterpret_cast<const OpeningBookEntry*>(this->mappedFile.getData() + sizeof(OpeningBookHeader));
+
+			if (mappedSize < sizeof(OpeningBookHeader) || std::memcmp(this->header->magic, getMagic(), sizeof(this->header->magic)) != 0) {
+				throwFileError(filePath, "the file is not an opening book");
+			}
+			else if (this->header->version != FILE_VERSION) {
+				throwFileError(filePath, "the book was written by a different version");
+			}
+			else if (mappedSize != sizeof(OpeningBookHeader) + this->header->numberOfEntries * sizeof(OpeningBookEntry)) {
+				throwFileError(filePath, "the file size does not match the number of entries");
+			}
+
+		}
+
+	public:
+
+		OpeningBook(const OpeningBook&) = delete;
+		OpeningBook& operator=(const OpeningBook&) = delete;
+
+		//Return the book in the file, mapping it the first time it is asked for. Every game that opens the same file
+		//shares one mapping.
+		static std::shared_ptr<const OpeningBook> open(const std::string& filePath) {
+
+			static std::mutex openingBooksMutex;
+			static std::map<std::string, std::shared_ptr<const OpeningBook>> openingBooks;
+
+			std::lock_guard<std::mutex> lock(openingBooksMutex);
+			std::shared_ptr<const OpeningBook>& openingBook = openingBooks[filePath];
+			if (!openingBook) {
+				openingBook.reset(new OpeningBook(filePath));
+			}
+
+			return openingBook;
+
+		}
+
+		//Sort the entries and write them out as a book for boards of the given size
+		static void write(const std::string& filePath, int numberOfRows, int numberOfColumns, std::vector<OpeningBookEntry> entries) {
+
+			std::sort(entries.begin(), entries.end(), [](const OpeningBookEntry& left, const OpeningBookEntry& right) {
+				return left.key < right.key;
+			});
+
+			OpeningBookHeader header;
+			std::memset(&header, 0, sizeof(header));
+			std::memcpy(header.magic, getMagic(), sizeof(header.magic));
+			header.version = FILE_VERSION;
+			header.numberOfRows = static_cast<std::uint8_t>(numberOfRows);
+			header.numberOfColumns = static_cast<std::uint8_t>(numberOfColumns);
+			header.numberOfEntries = entries.size();
+
+			std::ofstream bookFile(filePath, std::ios::binary | std::ios::trunc);
+			bookFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			bookFile.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(OpeningBookEntry));
+			if (!bookFile) {
+				std::stringstream errorMessage;
+				errorMessage << "Cannot write opening book " << filePath << ".";
+				throw std::runtime_error(errorMessage.str());
+			}
+
+		}
+
+		std::size_t getNumberOfEntries() const {
+
+			return static_cast<std::size_t>(this->header->numberOfEntries);
+
+		}
+
+		//Look up the position with the given player to move. Returns true and fills in the entry if the book has it, with
+		//the best move turned around to fit the board. Books only hold positions of games played to four in a row.
+		template <typename GameBoardType>
+		bool lookUp(const GameBoardType& gameBoard, bool isUserToMove, OpeningBookEntry& entry) const {
+
+			if (gameBoard.getNumberOfRows() != this->header->numberOfRows || gameBoard.getNumberOfColumns() != this->header->numberOfColumns ||
+				gameBoard.getWinLength() != GameBoardType::DEFAULT_WIN_LENGTH) {
+				return false;
+			}
+
+			std::uint64_t key = TranspositionTable::getKey(gameBoard.getCanonicalHash(), isUserToMove);
+			const OpeningBookEntry* entriesEnd = this->entries + this->header->numberOfEntries;
+			const OpeningBookEntry* foundEntry = std::lower_bound(this->entries, entriesEnd, key, [](const OpeningBookEntry& bookEntry, std::uint64_t key) {
+				return bookEntry.key < key;
+			});
+
+			if (foundEntry == entriesEnd || foundEntry->key != key) {
+				return false;
+			}
+
+			entry = *foundEntry;
+			entry.bestMove = static_cast<std::int8_t>(gameBoard.getCanonicalColumn(foundEntry->bestMove));
+			return true;
+
+		}
+
+	};
+
+}
@@ -0,0 +1,145 @@
+#include "GameBoard.hpp"
+#include "GameSessionManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+	//Constants for default values
+	const int DEFAULT_NUMBER_OF_SESSIONS = 24;
+	const int DEFAULT_DIFFICULTY_LEVEL = 6;
+	const int NUMBER_OF_ROWS = 6;
+	const int NUMBER_OF_COLUMNS = 7;
+	const unsigned int RANDOM_SEED = 5500;
+
+	//A session hosted by the manager, with a copy of its board to pick the next user move from
+	struct HostedSession {
+		int sessionId;
+		controller::SessionPriority priority;
+		model::GameBoard gameBoard;
+		bool isGameOver;
+	};
+
+	const char* getPriorityName(controller::SessionPriority priority) {
+
+		switch (priority) {
+		case controller::SessionPriority::low:
+			return "low";
+		case controller::SessionPriority::high:
+			return "high";
+		default:
+			return "normal";
+		}
+	}
+
+	//Random column that still has room
+	int pickUserMove(const model::GameBoard& gameBoard, std::mt19937& randomNumbers) {
+
+		std::vector<int> columns;
+		for (int columnCounter = 0; columnCounter < gameBoard.getNumberOfColumns(); ++columnCounter) {
+			if (gameBoard.canDropCoin(columnCounter)) {
+				columns.push_back(columnCounter);
+			}
+		}
+		return columns[std::uniform_int_distribution<std::size_t>(0, columns.size() - 1)(randomNumbers)];
+	}
+
+}
+
+//Host many games at once in the session manager, the priorities taking turns, and play random user moves in every
+//game until all of them are over. Each round hands one move of every game to the manager before waiting for the
+//replies, so the moves of all sessions are computed side by side. The latency percentiles of every session are
+//reported at the end.
+//Usage: RunSessions [number of sessions] [difficulty level]
+int main(int argc, char* argv[]) {
+
+	int numberOfSessions = argc > 1 ? std::atoi(argv[1]) : DEFAULT_NUMBER_OF_SESSIONS;
+	int difficultyLevel = argc > 2 ? std::atoi(argv[2]) : DEFAULT_DIFFICULTY_LEVEL;
+	if (numberOfSessions < 1 || difficultyLevel < 1) {
+		std::cerr << "Usage: RunSessions [number of sessions] [difficulty level]" << std::endl;
+		return 1;
+	}
+
+	const controller::SessionPriority priorities[] = { controller::SessionPriority::low, controller::SessionPriority::normal, controller::SessionPriority::high };
+	controller::GameSessionManager gameSessionManager;
+	std::vector<HostedSession> hostedSessions(numberOfSessions);
+	for (int sessionCounter = 0; sessionCounter < numberOfSessions; ++sessionCounter) {
+		HostedSession& hostedSession = hostedSessions[sessionCounter];
+		hostedSession.priority = priorities[sessionCounter % 3];
+		hostedSession.sessionId = gameSessionManager.createSession(NUMBER_OF_ROWS, NUMBER_OF_COLUMNS, difficultyLevel, hostedSession.priority);
+		hostedSession.gameBoard = model::GameBoard(NUMBER_OF_ROWS, NUMBER_OF_COLUMNS);
+		hostedSession.isGameOver = false;
+	}
+
+	std::mt19937 randomNumbers(RANDOM_SEED);
+	int numberOfGamesLeft = numberOfSessions;
+	int numberOfTurnedAwayMoves = 0;
+	std::chrono::steady_clock::duration slowestPercentileRead = std::chrono::steady_clock::duration::zero();
+	while (numberOfGamesLeft > 0) {
+
+		//Hand one move of every game still going to the manager
+		std::vector<std::future<controller::SessionMoveResult>> moveResults(numberOfSessions);
+		std::vector<int> userMoves(numberOfSessions, -1);
+		for (int sessionCounter = 0; sessionCounter < numberOfSessions; ++sessionCounter) {
+			HostedSession& hostedSession = hostedSessions[sessionCounter];
+			if (hostedSession.isGameOver) {
+				continue;
+			}
+
+			int userMove = pickUserMove(hostedSession.gameBoard, randomNumbers);
+			if (gameSessionManager.submitUserMove(hostedSession.sessionId, userMove, moveResults[sessionCounter])) {
+				userMoves[sessionCounter] = userMove;
+			}
+			else {
+				++numberOfTurnedAwayMoves;
+			}
+		}
+
+		//Reading the percentiles of a session must not wait for the move it has in progress
+		for (int sessionCounter = 0; sessionCounter < numberOfSessions; ++sessionCounter) {
+			if (userMoves[sessionCounter] >= 0) {
+				std::chrono::steady_clock::time_point readStartTime = std::chrono::steady_clock::now();
+				gameSessionManager.getLatencyPercentiles(hostedSessions[sessionCounter].sessionId);
+				slowestPercentileRead = std::max(slowestPercentileRead, std::chrono::steady_clock::now() - readStartTime);
+				break;
+			}
+		}
+
+		//Play the replies on the copies of the boards
+		for (int sessionCounter = 0; sessionCounter < numberOfSessions; ++sessionCounter) {
+			if (userMoves[sessionCounter] < 0) {
+				continue;
+			}
+
+			HostedSession& hostedSession = hostedSessions[sessionCounter];
+			controller::SessionMoveResult sessionMoveResult = moveResults[sessionCounter].get();
+			hostedSession.gameBoard.dropCoin(userMoves[sessionCounter], true);
+			if (sessionMoveResult.computerMoved) {
+				hostedSession.gameBoard.dropCoin(sessionMoveResult.searchResult.bestMove, false);
+			}
+
+			if (!sessionMoveResult.computerMoved || hostedSession.gameBoard.hasWinningLine(false) || hostedSession.gameBoard.isFull()) {
+				hostedSession.isGameOver = true;
+				--numberOfGamesLeft;
+			}
+		}
+
+	}
+
+	for (const HostedSession& hostedSession : hostedSessions) {
+		controller::LatencyPercentiles latencyPercentiles = gameSessionManager.getLatencyPercentiles(hostedSession.sessionId);
+		std::cout << "Session " << hostedSession.sessionId << " (" << getPriorityName(hostedSession.priority) << "): " << latencyPercentiles.numberOfMoves << " moves, median " <<
+			latencyPercentiles.median.count() << " us, 90th " << latencyPercentiles.ninetiethPercentile.count() << " us, 99th " << latencyPercentiles.ninetyNinthPercentile.count() <<
+			" us, max " << latencyPercentiles.maximum.count() << " us" << std::endl;
+		gameSessionManager.closeSession(hostedSession.sessionId);
+	}
+	std::cout << numberOfTurnedAwayMoves << " moves turned away, slowest percentile read while moves were running " <<
+		std::chrono::duration_cast<std::chrono::microseconds>(slowestPercentileRead).count() << " us" << std::endl;
+
+}
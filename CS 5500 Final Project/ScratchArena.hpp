@@ -0,0 +1,138 @@
+#pragma once
+
+#include <tbb\enumerable_thread_specific.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace controller {
+
+	//Bump allocator for the scratch buffers of a search, with one block of memory per thread so that the threads never
+	//share an allocator. A node takes its buffers through a scope, which hands the memory back when the node returns.
+	//Tasks a thread runs while it waits for other tasks finish before the wait does, so every thread frees its memory in
+	//the reverse order it took it. The blocks are allocated the first time a thread uses the arena and kept from one
+	//search to the next, so a search makes no calls to the heap once every thread has its block.
+	class ScratchArena {
+
+	private:
+
+		struct ThreadArena {
+			std::unique_ptr<unsigned char[]> memory;
+			std::size_t used;
+			std::size_t peak;
+
+			ThreadArena() : used(0), peak(0) {
+			}
+		};
+
+		//Constants
+		const static std::size_t ALIGNMENT = alignof(std::max_align_t);
+
+		//Members
+		tbb::enumerable_thread_specific<ThreadArena> threadArenas;
+		std::size_t capacity;
+
+	public:
+
+		const static std::size_t DEFAULT_CAPACITY = 64 * 1024;
+
+		//Scratch memory taken by one node of the search. Everything allocated through the scope is given back when the
+		//scope ends.
+		class Scope {
+
+		private:
+
+			//Members
+			ThreadArena& threadArena;
+			std::size_t capacity;
+			std::size_t mark;
+
+		public:
+
+			explicit Scope(ScratchArena& scratchArena) :
+				threadArena(scratchArena.threadArenas.local()), capacity(scratchArena.capacity), mark(threadArena.used) {
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+			~Scope() {
+
+				this->threadArena.used = this->mark;
+
+			}
+
+			//Return room for the number of values. The values are not initialized.
+			template <typename ValueType>
+			ValueType* allocate(std::size_t numberOfValues) {
+
+				static_assert(std::is_trivially_default_constructible<ValueType>::value && std::is_trivially_destructible<ValueType>::value,
+					"Only values that need no construction or destruction can be kept in a scratch arena.");
+
+				std::size_t size = (numberOfValues * sizeof(ValueType) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+				if (this->threadArena.used + size > this->capacity) {
+					std::stringstream errorMessage;
+					errorMessage << "The search needs more than " << this->capacity << " bytes of scratch memory in one thread.";
+					throw std::runtime_error(errorMessage.str());
+				}
+
+				if (!this->threadArena.memory) {
+					this->threadArena.memory.reset(new unsigned char[this->capacity]);
+				}
+
+				ValueType* values = reinterpret_cast<ValueType*>(this->threadArena.memory.get() + this->threadArena.used);
+				this->threadArena.used += size;
+				this->threadArena.peak = std::max(this->threadArena.peak, this->threadArena.used);
+				return values;
+
+			}
+
+		};
+
+		explicit ScratchArena(std::size_t capacity = DEFAULT_CAPACITY) : capacity(capacity) {
+		}
+
+		//Most scratch memory each thread can take during a search. The blocks are given back to the heap and allocated
+		//again at the new size. Must not be called while a search is using the arena.
+		void setCapacity(std::size_t capacity) {
+
+			this->threadArenas.clear();
+			this->capacity = capacity;
+
+		}
+
+		std::size_t getCapacity() const {
+
+			return this->capacity;
+
+		}
+
+		//Start a new search. Every thread starts with all of its block free and the peaks are cleared. Must not be called
+		//while a search is using the arena.
+		void reset() {
+
+			for (ThreadArena& threadArena : this->threadArenas) {
+				threadArena.used = 0;
+				threadArena.peak = 0;
+			}
+
+		}
+
+		//Most scratch memory held at once by each thread since the last reset, added up over the threads
+		std::size_t getPeakMemory() const {
+
+			std::size_t peakMemory = 0;
+			for (const ThreadArena& threadArena : this->threadArenas) {
+				peakMemory += threadArena.peak;
+			}
+			return peakMemory;
+
+		}
+
+	};
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+
+namespace controller {
+
+	//Shared by a running search and the thread that started it. The search checks the cancel flag at every node, so
+	//cancelling stops all of its tasks within a few nodes. The search posts the best move of each depth it finishes so
+	//that it can be polled while the search is still running.
+	class SearchControl {
+
+	private:
+
+		//Members
+		std::atomic<bool> cancelled;
+		std::atomic<int> currentBestMove;
+		std::atomic<int> currentDepth;
+
+	public:
+
+		SearchControl() : cancelled(false), currentBestMove(-1), currentDepth(0) {
+		}
+
+		//Ask the search to stop. The result it returns is then not reliable.
+		void cancel() {
+
+			this->cancelled.store(true, std::memory_order_relaxed);
+
+		}
+
+		bool isCancelled() const {
+
+			return this->cancelled.load(std::memory_order_relaxed);
+
+		}
+
+		//Called by the search each time it finishes a depth
+		void reportProgress(int bestMove, int depth) {
+
+			this->currentBestMove.store(bestMove);
+			this->currentDepth.store(depth);
+
+		}
+
+		//Best move of the deepest search finished so far, or -1 if no depth has been finished yet
+		int getCurrentBestMove() const {
+
+			return this->currentBestMove.load();
+
+		}
+
+		int getCurrentDepth() const {
+
+			return this->currentDepth.load();
+
+		}
+
+	};
+
+}
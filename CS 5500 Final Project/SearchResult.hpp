@@ -0,0 +1,32 @@
+#pragma once
+
+#include "SearchStats.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace controller {
+
+	//Search used by the computer to pick its move. The opening book looks the position up and searches it with alpha-beta
+	//only if it is not in the book. The endgame solver searches to the end of the game and scores by how soon it ends.
+	//Monte Carlo tree search plays random games instead of scoring positions, which reaches further on large boards.
+	//A forced move is played without searching when the threats on the board leave only one move worth playing, and is
+	//searched with alpha-beta otherwise. A move from the solved position store was found by an earlier solve, maybe in
+	//another process, and is never searched for.
+	enum class SearchAlgorithm { minimax, alphaBeta, openingBook, endgameSolver, monteCarloTreeSearch, forcedMove, solvedPositionStore };
+
+	//Outcome of a search for the computer move along with how much work it took. The node count and the most scratch
+	//memory the search held at once, in bytes, are always kept; the rest of the statistics only when they are compiled in.
+	struct SearchResult {
+		SearchAlgorithm searchAlgorithm;
+		int bestMove;
+		int score;
+		int depth;
+		std::uint64_t nodes;
+		std::size_t peakScratchMemory;
+		std::chrono::microseconds elapsedTime;
+		SearchStats searchStats;
+	};
+
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <tbb\combinable.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+//Search statistics are counted in debug builds and compiled out of release builds. Define CONNECT_FOUR_SEARCH_STATS
+//as 1 or 0 to choose either way.
+#ifndef CONNECT_FOUR_SEARCH_STATS
+#ifdef NDEBUG
+#define CONNECT_FOUR_SEARCH_STATS 0
+#else
+#define CONNECT_FOUR_SEARCH_STATS 1
+#endif
+#endif
+
+namespace controller {
+
+	//What a search did to find its move. All counts are zero when the statistics are compiled out.
+	//   nodes                      moves searched
+	//   leaves                     moves scored without searching the replies
+	//   cutoffs                    positions where a move scored at or above beta
+	//   transposition table probes positions looked up in the table, and hits the ones that were found
+	//   maximum depth              deepest move searched, counting the moves at the root as 1
+	//   evaluations                heuristic scores worked out for a move
+	//   task wait time             time threads spent inside task waits, including the tasks they ran while waiting.
+	//                              Compared with the elapsed time it shows how much of the search was spread over tasks.
+	struct SearchStats {
+		std::uint64_t nodes;
+		std::uint64_t leaves;
+		std::uint64_t cutoffs;
+		std::uint64_t transpositionTableProbes;
+		std::uint64_t transpositionTableHits;
+		std::uint64_t evaluations;
+		int maximumDepth;
+		std::chrono::microseconds taskWaitTime;
+	};
+
+	//Counts the statistics of a search in one shard per thread so that the threads never write to the same counters.
+	//The shards are merged when the search asks for the totals. Each thread keeps a pointer to its shard so that
+	//counting does not look the shard up every time. The pointer is tagged with an id that changes whenever the shards
+	//are cleared, so a stale pointer is never used.
+	class SearchStatsCounters {
+
+	private:
+
+		//Members
+		tbb::combinable<SearchStats> threadSearchStats;
+		std::atomic<std::uint64_t> countersId;
+
+		static std::uint64_t getNextCountersId() {
+
+			static std::atomic<std::uint64_t> nextCountersId(1);
+			return nextCountersId.fetch_add(1);
+
+		}
+
+		SearchStats& getThreadSearchStats() {
+
+			static thread_local std::uint64_t threadCountersId = 0;
+			static thread_local SearchStats* threadSearchStats = nullptr;
+
+			std::uint64_t countersId = this->countersId.load(std::memory_order_relaxed);
+			if (threadCountersId != countersId) {
+				threadSearchStats = &this->threadSearchStats.local();
+				threadCountersId = countersId;
+			}
+
+			return *threadSearchStats;
+
+		}
+
+		static SearchStats getEmptySearchStats() {
+
+			SearchStats searchStats = {};
+			searchStats.taskWaitTime = std::chrono::microseconds::zero();
+			return searchStats;
+
+		}
+
+		//Number of timed task waits the thread is in. Waits inside a wait are part of the outer one and are not timed.
+		static int& getTaskWaitNesting() {
+
+			static thread_local int taskWaitNesting = 0;
+			return taskWaitNesting;
+
+		}
+
+	public:
+
+		const static bool ENABLED = CONNECT_FOUR_SEARCH_STATS != 0;
+
+		//Times a wait for tasks from construction to destruction
+		class TaskWaitTimer {
+
+		private:
+
+			//Members
+			SearchStatsCounters& searchStatsCounters;
+			std::chrono::steady_clock::time_point startTime;
+
+		public:
+
+			explicit TaskWaitTimer(SearchStatsCounters& searchStatsCounters) : searchStatsCounters(searchStatsCounters) {
+
+				if constexpr (ENABLED) {
+					if (getTaskWaitNesting()++ == 0) {
+						this->startTime = std::chrono::steady_clock::now();
+					}
+				}
+
+			}
+
+			~TaskWaitTimer() {
+
+				if constexpr (ENABLED) {
+					if (--getTaskWaitNesting() == 0) {
+						SearchStats& searchStats = this->searchStatsCounters.getThreadSearchStats();
+						searchStats.taskWaitTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->startTime);
+					}
+				}
+
+			}
+
+		};
+
+		SearchStatsCounters() : threadSearchStats(getEmptySearchStats), countersId(getNextCountersId()) {
+		}
+
+		//A copy starts with no counts of its own
+		SearchStatsCounters(const SearchStatsCounters&) : threadSearchStats(getEmptySearchStats), countersId(getNextCountersId()) {
+		}
+
+		SearchStatsCounters& operator=(const SearchStatsCounters&) {
+
+			clear();
+			return *this;
+
+		}
+
+		void clear() {
+
+			if constexpr (ENABLED) {
+				this->threadSearchStats.clear();
+				this->countersId.store(getNextCountersId());
+			}
+
+		}
+
+		void countNode(int depth) {
+
+			if constexpr (ENABLED) {
+				SearchStats& searchStats = getThreadSearchStats();
+				++searchStats.nodes;
+				searchStats.maximumDepth = std::max(searchStats.maximumDepth, depth);
+			}
+
+		}
+
+		void countLeaf() {
+
+			if constexpr (ENABLED) {
+				++getThreadSearchStats().leaves;
+			}
+
+		}
+
+		void countCutoff() {
+
+			if constexpr (ENABLED) {
+				++getThreadSearchStats().cutoffs;
+			}
+
+		}
+
+		void countTranspositionTableProbe(bool isHit) {
+
+			if constexpr (ENABLED) {
+				SearchStats& searchStats = getThreadSearchStats();
+				++searchStats.transpositionTableProbes;
+				searchStats.transpositionTableHits += isHit ? 1 : 0;
+			}
+
+		}
+
+		void countEvaluation() {
+
+			if constexpr (ENABLED) {
+				++getThreadSearchStats().evaluations;
+			}
+
+		}
+
+		//Merge the shards of all the threads
+		SearchStats getSearchStats() {
+
+			if constexpr (ENABLED) {
+				return this->threadSearchStats.combine([](const SearchStats& left, const SearchStats& right) {
+					SearchStats searchStats;
+					searchStats.nodes = left.nodes + right.nodes;
+					searchStats.leaves = left.leaves + right.leaves;
+					searchStats.cutoffs = left.cutoffs + right.cutoffs;
+					searchStats.transpositionTableProbes = left.transpositionTableProbes + right.transpositionTableProbes;
+					searchStats.transpositionTableHits = left.transpositionTableHits + right.transpositionTableHits;
+					searchStats.evaluations = left.evaluations + right.evaluations;
+					searchStats.maximumDepth = std::max(left.maximumDepth, right.maximumDepth);
+					searchStats.taskWaitTime = left.taskWaitTime + right.taskWaitTime;
+					return searchStats;
+				});
+			}
+			else {
+				return getEmptySearchStats();
+			}
+
+		}
+
+	};
+
+}
@@ -0,0 +1,528 @@
+#include <tbb\global_control.h>
+#include <tbb\parallel_for.h>
+
+#include "ConnectFourGame.hpp"
+#include "GameBoard.hpp"
+#include "GameRecordFile.hpp"
+#include "HeuristicScorer.hpp"
+#include "MonteCarloTreeSearch.hpp"
+#include "SearchResult.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	//Constants for default values
+	const int DEFAULT_NUMBER_OF_GAMES = 1000;
+	const int DEFAULT_NUMBER_OF_OPENING_MOVES = 4;
+	const int DEFAULT_NUMBER_OF_ROWS = 6;
+	const int DEFAULT_NUMBER_OF_COLUMNS = 7;
+	const int DEFAULT_DIFFICULTY_LEVEL = 4;
+	const int DEFAULT_ENDGAME_SOLVER_THRESHOLD = 12;
+	const std::size_t DEFAULT_TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES = 4;
+	const int GAMES_PER_PROGRESS_REPORT = 100;
+
+	//Normal quantile of a two sided 95% confidence interval
+	const double CONFIDENCE_QUANTILE = 1.96;
+
+	//Settings of one of the two engines
+	struct EngineSettings {
+		controller::SearchAlgorithm searchAlgorithm;
+		int difficultyLevel;
+		int moveTimeBudgetInMilliseconds;
+		int endgameSolverThreshold;
+		std::size_t transpositionTableSizeInMegabytes;
+		controller::HeuristicWeights heuristicWeights;
+		controller::PlayoutPolicy playoutPolicy;
+		std::string openingBookPath;
+		std::string solvedPositionStorePath;
+	};
+
+	//Settings of the whole tournament. The candidate is the engine being tuned and the baseline the one it is measured
+	//against.
+	struct TournamentSettings {
+		int numberOfGames;
+		int numberOfOpeningMoves;
+		int numberOfRows;
+		int numberOfColumns;
+		int maximumNumberOfThreads;
+		std::uint64_t seed;
+		EngineSettings candidate;
+		EngineSettings baseline;
+	};
+
+	//Outcome of one game along with the work each engine did to play it
+	struct GameRecord {
+		bool candidatePlaysFirst;
+		std::string moves;
+		std::vector<int> columnsPlayed;
+		int candidateResult;
+		int numberOfCandidateMoves, numberOfBaselineMoves;
+		std::uint64_t candidateNodes, baselineNodes;
+		std::int64_t candidateMicroseconds, baselineMicroseconds;
+	};
+
+	EngineSettings getDefaultEngineSettings() {
+
+		EngineSettings engineSettings;
+		engineSettings.searchAlgorithm = controller::SearchAlgorithm::alphaBeta;
+		engineSettings.difficultyLevel = DEFAULT_DIFFICULTY_LEVEL;
+		engineSettings.moveTimeBudgetInMilliseconds = 0;
+		engineSettings.endgameSolverThreshold = DEFAULT_ENDGAME_SOLVER_THRESHOLD;
+		engineSettings.transpositionTableSizeInMegabytes = DEFAULT_TRANSPOSITION_TABLE_SIZE_IN_MEGABYTES;
+		engineSettings.heuristicWeights = controller::HeuristicScorer::getDefaultWeights();
+		engineSettings.playoutPolicy = controller::PlayoutPolicy::winsAndBlocks;
+		return engineSettings;
+	}
+
+	TournamentSettings getDefaultTournamentSettings() {
+
+		TournamentSettings tournamentSettings;
+		tournamentSettings.numberOfGames = DEFAULT_NUMBER_OF_GAMES;
+		tournamentSettings.numberOfOpeningMoves = DEFAULT_NUMBER_OF_OPENING_MOVES;
+		tournamentSettings.numberOfRows = DEFAULT_NUMBER_OF_ROWS;
+		tournamentSettings.numberOfColumns = DEFAULT_NUMBER_OF_COLUMNS;
+		tournamentSettings.maximumNumberOfThreads = 0;
+		tournamentSettings.seed = 1;
+		tournamentSettings.candidate = getDefaultEngineSettings();
+		tournamentSettings.baseline = getDefaultEngineSettings();
+		return tournamentSettings;
+	}
+
+	[[noreturn]] void throwConfigError(int lineNumber, const std::string& message) {
+
+		std::stringstream errorMessage;
+		errorMessage << "Line " << lineNumber << " of the config: " << message;
+		throw std::runtime_error(errorMessage.str());
+	}
+
+	//Read a whole number from a config value
+	long long readNumber(int lineNumber, const std::string& value) {
+
+		std::istringstream valueStream(value);
+		long long number;
+		if (!(valueStream >> number) || !(valueStream >> std::ws).eof()) {
+			throwConfigError(lineNumber, "\"" + value + "\" is not a number.");
+		}
+		return number;
+	}
+
+	//Engine settings are counts, sizes and durations, none of which can be negative
+	long long readNonNegativeNumber(int lineNumber, const std::string& value) {
+
+		long long number = readNumber(lineNumber, value);
+		if (number < 0) {
+			throwConfigError(lineNumber, "\"" + value + "\" is negative.");
+		}
+		return number;
+	}
+
+	controller::SearchAlgorithm readSearchAlgorithm(int lineNumber, const std::string& value) {
+
+		if (value == "minimax") {
+			return controller::SearchAlgorithm::minimax;
+		}
+		else if (value == "alphaBeta") {
+			return controller::SearchAlgorithm::alphaBeta;
+		}
+		else if (value == "monteCarloTreeSearch") {
+			return controller::SearchAlgorithm::monteCarloTreeSearch;
+		}
+		else if (value == "endgameSolver") {
+			return controller::SearchAlgorithm::endgameSolver;
+		}
+		else {
+			throwConfigError(lineNumber, "\"" + value + "\" is not one of minimax, alphaBeta, monteCarloTreeSearch or endgameSolver.");
+		}
+	}
+
+	//Weights are given as three numbers, for one, two and three coins in a row
+	controller::HeuristicWeights readHeuristicWeights(int lineNumber, const std::string& value) {
+
+		std::istringstream valueStream(value);
+		controller::HeuristicWeights heuristicWeights;
+		if (!(valueStream >> heuristicWeights.oneInRow >> heuristicWeights.twoInRow >> heuristicWeights.threeInRow) || !(valueStream >> std::ws).eof()) {
+			throwConfigError(lineNumber, "\"" + value + "\" is not three weights.");
+		}
+		return heuristicWeights;
+	}
+
+	void readEngineSetting(int lineNumber, const std::string& name, const std::string& value, EngineSettings& engineSettings) {
+
+		if (name == "algorithm") {
+			engineSettings.searchAlgorithm = readSearchAlgorithm(lineNumber, value);
+		}
+		else if (name == "depth") {
+			engineSettings.difficultyLevel = static_cast<int>(readNonNegativeNumber(lineNumber, value));
+		}
+		else if (name == "moveTimeMilliseconds") {
+			engineSettings.moveTimeBudgetInMilliseconds = static_cast<int>(readNonNegativeNumber(lineNumber, value));
+		}
+		else if (name == "endgameSolverThreshold") {
+			engineSettings.endgameSolverThreshold = static_cast<int>(readNonNegativeNumber(lineNumber, value));
+		}
+		else if (name == "transpositionTableMegabytes") {
+			engineSettings.transpositionTableSizeInMegabytes = static_cast<std::size_t>(readNonNegativeNumber(lineNumber, value));
+		}
+		else if (name == "weights") {
+			engineSettings.heuristicWeights = readHeuristicWeights(lineNumber, value);
+		}
+		else if (name == "playoutPolicy") {
+			if (value == "random") {
+				engineSettings.playoutPolicy = controller::PlayoutPolicy::random;
+			}
+			else if (value == "winsAndBlocks") {
+				engineSettings.playoutPolicy = controller::PlayoutPolicy::winsAndBlocks;
+			}
+			else {
+				throwConfigError(lineNumber, "\"" + value + "\" is not one of random or winsAndBlocks.");
+			}
+		}
+		else if (name == "openingBook") {
+			engineSettings.openingBookPath = value;
+		}
+		else if (name == "solvedPositions") {
+			engineSettings.solvedPositionStorePath = value;
+		}
+		else {
+			throwConfigError(lineNumber, "unknown engine setting \"" + name + "\".");
+		}
+	}
+
+	std::string trim(const std::string& text) {
+
+		std::size_t begin = text.find_first_not_of(" \t\r");
+		std::size_t end = text.find_last_not_of(" \t\r");
+		return begin == std::string::npos ? std::string() : text.substr(begin, end - begin + 1);
+	}
+
+	//Read the settings from a config file of "name = value" lines. Settings of an engine start with "candidate." or
+	//"baseline.", and everything after a # is a comment. Settings that are left out keep their default values.
+	TournamentSettings readConfig(const char* configFilePath) {
+
+		std::ifstream configFile(configFilePath);
+		if (!configFile) {
+			std::stringstream errorMessage;
+			errorMessage << "Cannot open the config file " << configFilePath << ".";
+			throw std::runtime_error(errorMessage.str());
+		}
+
+		TournamentSettings tournamentSettings = getDefaultTournamentSettings();
+		std::string line;
+		for (int lineNumber = 1; std::getline(configFile, line); ++lineNumber) {
+
+			line = trim(line.substr(0, line.find('#')));
+			if (line.empty()) {
+				continue;
+			}
+
+			std::size_t equalsSign = line.find('=');
+			if (equalsSign == std::string::npos) {
+				throwConfigError(lineNumber, "expected \"name = value\".");
+			}
+			std::string name = trim(line.substr(0, equalsSign));
+			std::string value = trim(line.substr(equalsSign + 1));
+
+			if (name.compare(0, 10, "candidate.") == 0) {
+				readEngineSetting(lineNumber, name.substr(10), value, tournamentSettings.candidate);
+			}
+			else if (name.compare(0, 9, "baseline.") == 0) {
+				readEngineSetting(lineNumber, name.substr(9), value, tournamentSettings.baseline);
+			}
+			else if (name == "games") {
+				tournamentSettings.numberOfGames = static_cast<int>(readNumber(lineNumber, value));
+			}
+			else if (name == "openingMoves") {
+				tournamentSettings.numberOfOpeningMoves = static_cast<int>(readNumber(lineNumber, value));
+			}
+			else if (name == "rows") {
+				tournamentSettings.numberOfRows = static_cast<int>(readNumber(lineNumber, value));
+			}
+			else if (name == "columns") {
+				tournamentSettings.numberOfColumns = static_cast<int>(readNumber(lineNumber, value));
+			}
+			else if (name == "threads") {
+				tournamentSettings.maximumNumberOfThreads = static_cast<int>(readNumber(lineNumber, value));
+			}
+			else if (name == "seed") {
+				tournamentSettings.seed = static_cast<std::uint64_t>(readNumber(lineNumber, value));
+			}
+			else {
+				throwConfigError(lineNumber, "unknown setting \"" + name + "\".");
+			}
+		}
+
+		return tournamentSettings;
+	}
+
+	//Check the settings before any game is played, so that a bad config is reported once instead of by every game
+	void checkSettings(const TournamentSettings& tournamentSettings) {
+
+		if (tournamentSettings.numberOfGames < 1 || tournamentSettings.numberOfOpeningMoves < 0) {
+			throw std::runtime_error("The config needs at least one game and no fewer than zero opening moves.");
+		}
+
+		model::GameBoard gameBoard(tournamentSettings.numberOfRows, tournamentSettings.numberOfColumns);
+		controller::HeuristicScorer candidateScorer(tournamentSettings.candidate.heuristicWeights);
+		controller::HeuristicScorer baselineScorer(tournamentSettings.baseline.heuristicWeights);
+	}
+
+	//Set up a new game for an engine so that no game starts with positions scored in an earlier one
+	std::unique_ptr<controller::ConnectFourGame> createEngine(const TournamentSettings& tournamentSettings, const EngineSettings& engineSettings) {
+
+		std::unique_ptr<controller::ConnectFourGame> connectFourGame(new controller::ConnectFourGame(tournamentSettings.numberOfRows, tournamentSettings.numberOfColumns,
+			model::GameBoard::DEFAULT_WIN_LENGTH, engineSettings.transpositionTableSizeInMegabytes));
+		connectFourGame->setHeuristicWeights(engineSettings.heuristicWeights);
+		connectFourGame->setSearchAlgorithm(engineSettings.searchAlgorithm);
+		connectFourGame->setgameDifficultyLevel(engineSettings.difficultyLevel);
+		connectFourGame->setMoveTimeBudget(std::chrono::milliseconds(engineSettings.moveTimeBudgetInMilliseconds));
+		connectFourGame->setEndgameSolverThreshold(engineSettings.endgameSolverThreshold);
+		connectFourGame->setPlayoutPolicy(engineSettings.playoutPolicy);
+		connectFourGame->setOpeningBook(engineSettings.openingBookPath);
+		connectFourGame->setSolvedPositionStore(engineSettings.solvedPositionStorePath);
+		return connectFourGame;
+	}
+
+	//Write a column as one character, 0 to 9 and then a to z
+	char getColumnCharacter(int columnNumber) {
+
+		return static_cast<char>(columnNumber < 10 ? '0' + columnNumber : 'a' + columnNumber - 10);
+	}
+
+	//Play random moves that do not win until the opening is as long as asked. Both games of an opening pair start from
+	//the same moves, so the random seed only depends on the pair.
+	std::vector<int> playRandomOpening(const TournamentSettings& tournamentSettings, int openingNumber) {
+
+		std::mt19937_64 randomNumbers(tournamentSettings.seed * 1000003 + openingNumber);
+		model::GameBoard gameBoard(tournamentSettings.numberOfRows, tournamentSettings.numberOfColumns);
+		std::vector<int> openingMoves;
+		bool isFirstPlayerCoin = true;
+
+		while (static_cast<int>(openingMoves.size()) < tournamentSettings.numberOfOpeningMoves) {
+
+			std::vector<int> columns;
+			for (int columnNumber = 0; columnNumber < gameBoard.getNumberOfColumns(); ++columnNumber) {
+				if (gameBoard.canDropCoin(columnNumber) && !gameBoard.isWinningDrop(columnNumber, isFirstPlayerCoin)) {
+					columns.push_back(columnNumber);
+				}
+			}
+			if (columns.empty() || gameBoard.getNumberOfCoins() + 1 >= gameBoard.getNumberOfRows() * gameBoard.getNumberOfColumns()) {
+				break;
+			}
+
+			int columnNumber = columns[std::uniform_int_distribution<std::size_t>(0, columns.size() - 1)(randomNumbers)];
+			gameBoard.dropCoin(columnNumber, isFirstPlayerCoin);
+			openingMoves.push_back(columnNumber);
+			isFirstPlayerCoin = isFirstPlayerCoin ? false : true;
+		}
+
+		return openingMoves;
+	}
+
+	//Play one game from the opening to the end. Each engine sees the board with its own coins as the computer coins.
+	GameRecord playGame(const TournamentSettings& tournamentSettings, const std::vector<int>& openingMoves, bool candidatePlaysFirst) {
+
+		std::unique_ptr<controller::ConnectFourGame> candidate = createEngine(tournamentSettings, tournamentSettings.candidate);
+		std::unique_ptr<controller::ConnectFourGame> baseline = createEngine(tournamentSettings, tournamentSettings.baseline);
+
+		GameRecord gameRecord = {};
+		gameRecord.candidatePlaysFirst = candidatePlaysFirst;
+
+		model::GameBoard candidateGameBoard(tournamentSettings.numberOfRows, tournamentSettings.numberOfColumns);
+		model::GameBoard baselineGameBoard(tournamentSettings.numberOfRows, tournamentSettings.numberOfColumns);
+		bool isCandidateToMove = candidatePlaysFirst;
+		for (int columnNumber : openingMoves) {
+			candidateGameBoard.dropCoin(columnNumber, isCandidateToMove ? false : true);
+			baselineGameBoard.dropCoin(columnNumber, isCandidateToMove);
+			gameRecord.moves += getColumnCharacter(columnNumber);
+			gameRecord.columnsPlayed.push_back(columnNumber);
+			isCandidateToMove = isCandidateToMove ? false : true;
+		}
+
+		while (!candidateGameBoard.isFull()) {
+
+			controller::ConnectFourGame& engine = isCandidateToMove ? *candidate : *baseline;
+			engine.setGameBoard(isCandidateToMove ? candidateGameBoard : baselineGameBoard);
+			int columnNumber = engine.playComputerMoveNow();
+			controller::SearchResult searchResult = engine.getLastSearchResult();
+
+			if (isCandidateToMove) {
+				++gameRecord.numberOfCandidateMoves;
+				gameRecord.candidateNodes += searchResult.nodes;
+				gameRecord.candidateMicroseconds += searchResult.elapsedTime.count();
+			}
+			else {
+				++gameRecord.numberOfBaselineMoves;
+				gameRecord.baselineNodes += searchResult.nodes;
+				gameRecord.baselineMicroseconds += searchResult.elapsedTime.count();
+			}
+
+			bool isWinningDrop = candidateGameBoard.isWinningDrop(columnNumber, isCandidateToMove ? false : true);
+			candidateGameBoard.dropCoin(columnNumber, isCandidateToMove ? false : true);
+			baselineGameBoard.dropCoin(columnNumber, isCandidateToMove);
+			gameRecord.moves += getColumnCharacter(columnNumber);
+			gameRecord.columnsPlayed.push_back(columnNumber);
+
+			if (isWinningDrop) {
+				gameRecord.candidateResult = isCandidateToMove ? 1 : -1;
+				return gameRecord;
+			}
+			isCandidateToMove = isCandidateToMove ? false : true;
+		}
+
+		gameRecord.candidateResult = 0;
+		return gameRecord;
+	}
+
+	//Elo difference at which an engine is expected to take the share of the points, or plus or minus infinity for a
+	//clean sweep
+	double getEloDifference(double pointShare) {
+
+		if (pointShare <= 0.0) {
+			return -INFINITY;
+		}
+		else if (pointShare >= 1.0) {
+			return INFINITY;
+		}
+		else {
+			return -400.0 * std::log10(1.0 / pointShare - 1.0);
+		}
+	}
+
+	void reportEngine(const char* engineName, const EngineSettings& engineSettings, int numberOfMoves, std::uint64_t nodes, std::int64_t microseconds) {
+
+		std::cout << std::setw(10) << std::left << engineName << std::right << " weights " << engineSettings.heuristicWeights.oneInRow << " " <<
+			engineSettings.heuristicWeights.twoInRow << " " << engineSettings.heuristicWeights.threeInRow << ", " << numberOfMoves << " moves, " <<
+			(numberOfMoves > 0 ? nodes / numberOfMoves : 0) << " nodes/move, " << std::fixed << std::setprecision(3) <<
+			(numberOfMoves > 0 ? microseconds / 1000.0 / numberOfMoves : 0.0) << " ms/move" << std::endl;
+	}
+
+}
+
+//Play the candidate engine against the baseline engine, both set up from the config file, and report how the
+//candidate scored with a 95% confidence interval. Games are played in pairs from the same random opening, once with
+//each engine going first, and spread over all the cores. The work each engine did is reported as well, so that
+//settings can be compared by strength for the compute they take. Each game is logged as one line: the game number,
+//"c" or "b" for the engine that went first, the columns played and the result for the candidate. The games can also
+//be saved as a game record file to replay them later, with the candidate as the user.
+//Usage: SelfPlay <config file> [log file] [game record file]
+int main(int argc, char* argv[]) {
+
+	if (argc < 2) {
+		std::cerr << "Usage: SelfPlay <config file> [log file] [game record file]" << std::endl;
+		return 1;
+	}
+
+	TournamentSettings tournamentSettings;
+	try {
+		tournamentSettings = readConfig(argv[1]);
+		checkSettings(tournamentSettings);
+
+		//Build each engine once so that a bad opening book or solved position file is reported here, and not thrown
+		//from inside the games played in parallel
+		createEngine(tournamentSettings, tournamentSettings.candidate);
+		createEngine(tournamentSettings, tournamentSettings.baseline);
+	}
+	catch (const std::exception& exception) {
+		std::cerr << exception.what() << std::endl;
+		return 1;
+	}
+
+	int maximumNumberOfThreads = tournamentSettings.maximumNumberOfThreads > 0 ? tournamentSettings.maximumNumberOfThreads : static_cast<int>(std::thread::hardware_concurrency());
+	tbb::global_control threadLimit(tbb::global_control::max_allowed_parallelism, std::max(maximumNumberOfThreads, 1));
+	std::cout << "Playing " << tournamentSettings.numberOfGames << " games on " << tournamentSettings.numberOfRows << "x" << tournamentSettings.numberOfColumns <<
+		" boards with up to " << maximumNumberOfThreads << " threads" << std::endl;
+
+	//Every game is played on its own engines, so the games only share the counter of finished games
+	std::vector<GameRecord> gameRecords(tournamentSettings.numberOfGames);
+	std::atomic<int> numberOfFinishedGames(0);
+	std::mutex progressMutex;
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	tbb::parallel_for(0, tournamentSettings.numberOfGames, [&](int gameNumber) {
+
+		gameRecords[gameNumber] = playGame(tournamentSettings, playRandomOpening(tournamentSettings, gameNumber / 2), gameNumber % 2 == 0);
+
+		int finishedGames = ++numberOfFinishedGames;
+		if (finishedGames % GAMES_PER_PROGRESS_REPORT == 0) {
+			std::lock_guard<std::mutex> lock(progressMutex);
+			std::cout << finishedGames << " of " << tournamentSettings.numberOfGames << " games played" << std::endl;
+		}
+	});
+	double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	int wins = 0, draws = 0, losses = 0;
+	int numberOfCandidateMoves = 0, numberOfBaselineMoves = 0;
+	std::uint64_t candidateNodes = 0, baselineNodes = 0;
+	std::int64_t candidateMicroseconds = 0, baselineMicroseconds = 0;
+	for (const GameRecord& gameRecord : gameRecords) {
+		wins += gameRecord.candidateResult > 0 ? 1 : 0;
+		draws += gameRecord.candidateResult == 0 ? 1 : 0;
+		losses += gameRecord.candidateResult < 0 ? 1 : 0;
+		numberOfCandidateMoves += gameRecord.numberOfCandidateMoves;
+		numberOfBaselineMoves += gameRecord.numberOfBaselineMoves;
+		candidateNodes += gameRecord.candidateNodes;
+		baselineNodes += gameRecord.baselineNodes;
+		candidateMicroseconds += gameRecord.candidateMicroseconds;
+		baselineMicroseconds += gameRecord.baselineMicroseconds;
+	}
+
+	//A win counts as one point and a draw as half. The interval comes from the spread of the points of single games.
+	int numberOfGames = tournamentSettings.numberOfGames;
+	double pointShare = (wins + 0.5 * draws) / numberOfGames;
+	double pointVariance = (wins + 0.25 * draws) / numberOfGames - pointShare * pointShare;
+	double confidenceMargin = CONFIDENCE_QUANTILE * std::sqrt(std::max(pointVariance, 0.0) / numberOfGames);
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "Played " << tournamentSettings.numberOfGames << " games in " << elapsedSeconds << " s" << std::endl;
+	std::cout << "Candidate: " << wins << " wins, " << draws << " draws, " << losses << " losses" << std::endl;
+	std::cout << "Score " << 100.0 * pointShare << "% +- " << 100.0 * confidenceMargin << "%, Elo " << getEloDifference(pointShare) <<
+		" [" << getEloDifference(pointShare - confidenceMargin) << ", " << getEloDifference(pointShare + confidenceMargin) << "]" << std::endl;
+	reportEngine("Candidate", tournamentSettings.candidate, numberOfCandidateMoves, candidateNodes, candidateMicroseconds);
+	reportEngine("Baseline", tournamentSettings.baseline, numberOfBaselineMoves, baselineNodes, baselineMicroseconds);
+
+	if (argc > 2) {
+		std::ofstream logFile(argv[2]);
+		for (std::size_t gameCounter = 0; gameCounter < gameRecords.size(); ++gameCounter) {
+			const GameRecord& gameRecord = gameRecords[gameCounter];
+			logFile << gameCounter << " " << (gameRecord.candidatePlaysFirst ? "c" : "b") << " " << gameRecord.moves << " " <<
+				(gameRecord.candidateResult > 0 ? "1-0" : (gameRecord.candidateResult < 0 ? "0-1" : "1/2")) << "\n";
+		}
+		if (!logFile) {
+			std::cerr << "Cannot write " << argv[2] << std::endl;
+			return 1;
+		}
+		std::cout << "Wrote " << gameRecords.size() << " games to " << argv[2] << std::endl;
+	}
+
+	if (argc > 3) {
+		try {
+			controller::GameRecordWriter gameRecordWriter(argv[3], tournamentSettings.numberOfRows, tournamentSettings.numberOfColumns, controller::GameRecordKind::games);
+			for (const GameRecord& gameRecord : gameRecords) {
+				controller::GameOutcome gameOutcome = gameRecord.candidateResult > 0 ? controller::GameOutcome::userWon :
+					(gameRecord.candidateResult < 0 ? controller::GameOutcome::computerWon : controller::GameOutcome::draw);
+				gameRecordWriter.writeGame(gameRecord.columnsPlayed.data(), static_cast<int>(gameRecord.columnsPlayed.size()), gameRecord.candidatePlaysFirst, gameOutcome);
+			}
+			gameRecordWriter.close();
+		}
+		catch (const std::exception& exception) {
+			std::cerr << exception.what() << std::endl;
+			return 1;
+		}
+		std::cout << "Wrote " << gameRecords.size() << " game records to " << argv[3] << std::endl;
+	}
+
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include "GameBoard.hpp"
+#include "MappedFile.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace controller {
+
+	//Exact result of a solved position. The score is on the scale of the endgame solver, so a win with k slots still
+	//empty after the winning coin scores k + 1, a draw 0 and a loss the negative of the win of the opponent.
+	struct SolvedPosition {
+		int score;
+		int bestMove;
+	};
+
+	//Start of a solved position file. The slots follow it.
+	struct SolvedPositionStoreHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint8_t numberOfRows;
+		std::uint8_t numberOfColumns;
+		std::uint8_t reserved[2];
+		std::uint64_t numberOfSlots;
+		std::uint64_t reserved2[5];
+	};
+
+	static_assert(sizeof(SolvedPositionStoreHeader) == 64, "The solved position header is written to the file as it is laid out in memory.");
+
+	//Positions solved exactly by the endgame solver, kept in a file that is mapped into memory and shared by every
+	//process on the machine that opens it, so that what one process proves is found by the others and by the processes
+	//that come after it. The file is a hash table of a fixed number of slots, each holding the packed position in one
+	//word and the player to move, score and best move in the other. Slots are only ever filled, never overwritten:
+	//a writer claims an empty slot by swapping the position into it, then writes the result, so threads and processes
+	//can add positions at the same time without locks and a reader never sees half an entry. Positions are stored
+	//exactly rather than by their hash, so a result is never given to the wrong position. A position and its mirror
+	//image share one slot, like in the transposition table. When every slot a position could go in is taken, the
+	//position is not saved.
+	class SolvedPositionStore {
+
+	private:
+
+		struct Slot {
+			std::atomic<std::uint64_t> packedPosition;
+			std::atomic<std::uint64_t> data;
+		};
+
+		static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Slots are shared with other processes, which only works without locks.");
+		static_assert(sizeof(Slot) == 16, "Slots are laid out in the file as they are in memory.");
+
+		//Constants
+		const static std::uint32_t FILE_VERSION = 1;
+		const static std::size_t BYTES_IN_MEGABYTE = 1024 * 1024;
+		const static int MAXIMUM_NUMBER_OF_PROBES = 16;
+		const static std::uint64_t FILLED_BIT = 1;
+		const static std::uint64_t USER_TO_MOVE_BIT = 2;
+		const static std::uint64_t NO_BEST_MOVE = 0xFF;
+		const static int BEST_MOVE_SHIFT = 8;
+		const static int SCORE_SHIFT = 16;
+
+		//Members
+		SharedMappedFile mappedFile;
+		const SolvedPositionStoreHeader* header;
+		Slot* slots;
+
+		static const char* getMagic() {
+
+			return "C4SOLVED";
+
+		}
+
+		//Data word of a result. The filled bit keeps it from ever being zero, which marks a slot whose result is still
+		//being written.
+		static std::uint64_t packData(bool isUserToMove, int score, int bestMove) {
+
+			std::uint64_t packedBestMove = bestMove < 0 ? NO_BEST_MOVE : static_cast<std::uint64_t>(bestMove);
+			return FILLED_BIT | (isUserToMove ? USER_TO_MOVE_BIT : 0) | (packedBestMove << BEST_MOVE_SHIFT) |
+				(static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << SCORE_SHIFT);
+
+		}
+
+		static bool hasUserToMove(std::uint64_t data) {
+
+			return (data & USER_TO_MOVE_BIT) != 0;
+
+		}
+
+		//Spread the packed position over the table. The player to move picks a different slot for the same coins.
+		std::size_t getFirstSlotNumber(std::uint64_t packedPosition, bool isUserToMove) const {
+
+			std::uint64_t hash = packedPosition ^ (isUserToMove ? 0x9E3779B97F4A7C15ULL : 0);
+			hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+			hash = hash ^ (hash >> 31);
+			return static_cast<std::size_t>(hash & (this->header->numberOfSlots - 1));
+
+		}
+
+		//Check that the board is the size of the positions in the file. Only games played to four in a row are stored.
+		template <typename GameBoardType>
+		bool fitsBoard(const GameBoardType& gameBoard) const {
+
+			return gameBoard.getNumberOfRows() == this->header->numberOfRows && gameBoard.getNumberOfColumns() == this->header->numberOfColumns &&
+				gameBoard.getWinLength() == GameBoardType::DEFAULT_WIN_LENGTH;
+
+		}
+
+		//Map the file and set it up if it is new. An existing file keeps its size and has to be for boards of the same size.
+		SolvedPositionStore(const std::string& filePath, int numberOfRows, int numberOfColumns, std::size_t sizeInMegabytes) :
+			mappedFile(filePath, "solved positions", getFileSize(sizeInMegabytes), [&filePath, numberOfRows, numberOfColumns](unsigned char* data, std::size_t size, bool isNewFile) {
+
+				SolvedPositionStoreHeader* header = reinterpret_cast<SolvedPositionStoreHeader*>(data);
+				if (isNewFile) {
+					std::memset(header, 0, sizeof(SolvedPositionStoreHeader));
+					std::memcpy(header->magic, getMagic(), sizeof(header->magic));
+					header->version = FILE_VERSION;
+					header->numberOfRows = static_cast<std::uint8_t>(numberOfRows);
+					header->numberOfColumns = static_cast<std::uint8_t>(numberOfColumns);
+					header->numberOfSlots = (size - sizeof(SolvedPositionStoreHeader)) / sizeof(Slot);
+				}
+				else if (size < sizeof(SolvedPositionStoreHeader) || std::memcmp(header->magic, getMagic(), sizeof(header->magic)) != 0) {
+					MappedFile::throwFileError("solved positions", filePath, "the file does not hold solved positions");
+				}
+				else if (header->version != FILE_VERSION) {
+					MappedFile::throwFileError("solved positions", filePath, "the positions were written by a different version");
+				}
+				else if (header->numberOfRows != numberOfRows || header->numberOfColumns != numberOfColumns) {
+					MappedFile::throwFileError("solved positions", filePath, "the positions are for boards of another size");
+				}
+				else if (size != sizeof(SolvedPositionStoreHeader) + header->numberOfSlots * sizeof(Slot) ||
+					header->numberOfSlots == 0 || (header->numberOfSlots & (header->numberOfSlots - 1)) != 0) {
+					MappedFile::throwFileError("solved positions", filePath, "the file size does not match the number of slots");
+				}
+			}) {
+
+			this->header = reinterpret_cast<const SolvedPositionStoreHeader*>(this->mappedFile.getData());
+			this->slots = reinterpret_cast<Slot*>(this->mappedFile.getData() + sizeof(SolvedPositionStoreHeader));
+
+		}
+
+		//Use the largest power of two number of slots that fits in the size, and at least one
+		static std::size_t getFileSize(std::size_t sizeInMegabytes) {
+
+			std::size_t numberOfSlots = 1;
+			while (numberOfSlots * 2 * sizeof(Slot) <= sizeInMegabytes * BYTES_IN_MEGABYTE) {
+				numberOfSlots *= 2;
+			}
+			return sizeof(SolvedPositionStoreHeader) + numberOfSlots * sizeof(Slot);
+
+		}
+
+	public:
+
+		//Size given to a new file
+		const static std::size_t DEFAULT_SIZE_IN_MEGABYTES = 64;
+
+		SolvedPositionStore(const SolvedPositionStore&) = delete;
+		SolvedPositionStore& operator=(const SolvedPositionStore&) = delete;
+
+		//Return the store in the file, mapping it the first time it is asked for and creating the file if it does not
+		//exist. Every game in the process that opens the same file shares one mapping. The positions of the board have to
+		//fit into one word.
+		static std::shared_ptr<SolvedPositionStore> open(const std::string& filePath, int numberOfRows, int numberOfColumns, std::size_t sizeInMegabytes = DEFAULT_SIZE_IN_MEGABYTES) {
+
+			if (!model::GameBoard::fitsPackedPosition(numberOfRows, numberOfColumns)) {
+				std::stringstream errorMessage;
+				errorMessage << "Positions of a board with " << numberOfRows << " rows and " << numberOfColumns << " columns cannot be stored as solved positions.";
+				throw std::logic_error(errorMessage.str());
+			}
+
+			static std::mutex solvedPositionStoresMutex;
+			static std::map<std::string, std::shared_ptr<SolvedPositionStore>> solvedPositionStores;
+
+			std::lock_guard<std::mutex> lock(solvedPositionStoresMutex);
+			std::shared_ptr<SolvedPositionStore>& solvedPositionStore = solvedPositionStores[filePath];
+			if (!solvedPositionStore) {
+				solvedPositionStore.reset(new SolvedPositionStore(filePath, numberOfRows, numberOfColumns, sizeInMegabytes));
+			}
+			else if (solvedPositionStore->getNumberOfRows() != numberOfRows || solvedPositionStore->getNumberOfColumns() != numberOfColumns) {
+				MappedFile::throwFileError("solved positions", filePath, "the positions are for boards of another size");
+			}
+
+			return solvedPositionStore;
+
+		}
+
+		int getNumberOfRows() const {
+
+			return this->header->numberOfRows;
+
+		}
+
+		int getNumberOfColumns() const {
+
+			return this->header->numberOfColumns;
+
+		}
+
+		std::size_t getNumberOfSlots() const {
+
+			return static_cast<std::size_t>(this->header->numberOfSlots);
+
+		}
+
+		//Look up the position with the given player to move. Returns true and fills in the result if it has been solved,
+		//with the best move turned around to fit the board.
+		template <typename GameBoardType>
+		bool lookUp(const GameBoardType& gameBoard, bool isUserToMove, SolvedPosition& solvedPosition) const {
+
+			if (!fitsBoard(gameBoard)) {
+				return false;
+			}
+
+			std::uint64_t packedPosition = gameBoard.getCanonicalPackedPosition();
+			std::size_t slotNumber = getFirstSlotNumber(packedPosition, isUserToMove);
+			for (int probeCounter = 0; probeCounter < MAXIMUM_NUMBER_OF_PROBES; ++probeCounter) {
+
+				const Slot& slot = this->slots[(slotNumber + probeCounter) & (this->header->numberOfSlots - 1)];
+				std::uint64_t slotPackedPosition = slot.packedPosition.load(std::memory_order_acquire);
+				if (slotPackedPosition == 0) {
+					return false;
+				}
+
+				//A slot whose result is still being written is passed over
+				std::uint64_t data = slot.data.load(std::memory_order_acquire);
+				if (slotPackedPosition == packedPosition && data != 0 && hasUserToMove(data) == isUserToMove) {
+					std::uint64_t packedBestMove = (data >> BEST_MOVE_SHIFT) & 0xFF;
+					solvedPosition.score = static_cast<std::int16_t>(data >> SCORE_SHIFT);
+					solvedPosition.bestMove = packedBestMove == NO_BEST_MOVE ? -1 : gameBoard.getCanonicalColumn(static_cast<int>(packedBestMove));
+					return true;
+				}
+			}
+
+			return false;
+
+		}
+
+		//Save the exact result of the position with the given player to move. Returns false if it was not saved because
+		//the slots it could go in are taken. A position that is already saved is left as it is, since an exact result
+		//never changes.
+		template <typename GameBoardType>
+		bool store(const GameBoardType& gameBoard, bool isUserToMove, int score, int bestMove) {
+
+			if (!fitsBoard(gameBoard)) {
+				return false;
+			}
+
+			std::uint64_t packedPosition = gameBoard.getCanonicalPackedPosition();
+			std::uint64_t data = packData(isUserToMove, score, gameBoard.getCanonicalColumn(bestMove));
+			std::size_t slotNumber = getFirstSlotNumber(packedPosition, isUserToMove);
+			for (int probeCounter = 0; probeCounter < MAXIMUM_NUMBER_OF_PROBES; ++probeCounter) {
+
+				Slot& slot = this->slots[(slotNumber + probeCounter) & (this->header->numberOfSlots - 1)];
+				std::uint64_t slotPackedPosition = 0;
+				if (slot.packedPosition.compare_exchange_strong(slotPackedPosition, packedPosition, std::memory_order_acq_rel)) {
+					slot.data.store(data, std::memory_order_release);
+					return true;
+				}
+				else if (slotPackedPosition == packedPosition) {
+					std::uint64_t slotData = slot.data.load(std::memory_order_acquire);
+					if (slotData != 0 && hasUserToMove(slotData) == isUserToMove) {
+						return true;
+					}
+				}
+			}
+
+			return false;
+
+		}
+
+	};
+
+}
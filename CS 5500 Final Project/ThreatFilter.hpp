@@ -0,0 +1,155 @@
+#pragma once
+
+#include "GameBoard.hpp"
+
+#include <cstdint>
+
+namespace controller {
+
+	//What the threats on the board say about the position of the player to move
+	//   open           nothing is settled, search the columns that are left
+	//   win            a coin completes a winning line right away
+	//   doubleThreat   a coin leaves two wins the opponent cannot both block
+	//   loss           the opponent wins on the next move whatever is played
+	enum class ThreatOutcome { open, win, doubleThreat, loss };
+
+	//Outcome of the threat filter along with a bit for every column worth playing. A win or double threat has the
+	//columns that get it, a loss the columns that hold the opponent off the longest, and an open position the columns
+	//left to search.
+	struct ThreatFilterResult {
+		ThreatOutcome outcome;
+		std::uint32_t columns;
+	};
+
+	//Looks at the immediate threats of a position with bitboard masks before it is searched. A win is played at once, an
+	//opponent win has to be blocked, and a coin dropped right below a slot where the opponent would win is left out,
+	//since the opponent would simply win on top of it. A position where the opponent has two wins, or where every move
+	//hands the opponent one, is lost. A coin that leaves two wins of its own wins unless the opponent can win first.
+	class ThreatFilter {
+
+	private:
+
+		//Return a bit for the column of each drop bit
+		template <typename GameBoardType>
+		static std::uint32_t getColumns(const GameBoardType& gameBoard, const typename GameBoardType::Bitboard& dropBits) {
+
+			std::uint32_t columns = 0;
+			for (int columnCounter = 0; columnCounter < gameBoard.getNumberOfColumns(); ++columnCounter) {
+				if (dropBits.hasBit(gameBoard.getDropBitNumber(columnCounter))) {
+					columns |= std::uint32_t(1) << columnCounter;
+				}
+			}
+			return columns;
+
+		}
+
+	public:
+
+		//Every column
+		const static std::uint32_t ALL_COLUMNS = 0xFFFFFFFF;
+
+		static bool containsColumn(std::uint32_t columns, int columnNumber) {
+
+			return ((columns >> columnNumber) & 1) != 0;
+
+		}
+
+		//Return the leftmost column of the set, or -1 if it is empty
+		static int getFirstColumn(std::uint32_t columns) {
+
+			for (int columnCounter = 0; columnCounter < 32; ++columnCounter) {
+				if (containsColumn(columns, columnCounter)) {
+					return columnCounter;
+				}
+			}
+			return -1;
+
+		}
+
+		//Check if the set holds exactly one column
+		static bool isSingleColumn(std::uint32_t columns) {
+
+			return columns != 0 && (columns & (columns - 1)) == 0;
+
+		}
+
+		//Check if the filter leaves only one move worth playing, so that the position needs no search
+		static bool isForced(const ThreatFilterResult& threatFilterResult) {
+
+			return threatFilterResult.outcome != ThreatOutcome::open || isSingleColumn(threatFilterResult.columns);
+
+		}
+
+		//Filter the moves of the player to move. Only threats that play out within the given number of moves are used: a
+		//win needs one move, blocks and losses two, since they turn on the reply of the opponent, and double threats three.
+		template <typename GameBoardType>
+		static ThreatFilterResult filterMoves(const GameBoardType& gameBoard, bool isUserCoin, int numberOfMovesAhead) {
+
+			typedef typename GameBoardType::Bitboard Bitboard;
+
+			ThreatFilterResult threatFilterResult;
+			Bitboard dropBits = gameBoard.getDropBits();
+
+			Bitboard winningDropBits = gameBoard.getWinningBits(isUserCoin) & dropBits;
+			if (!winningDropBits.isEmpty()) {
+				threatFilterResult.outcome = ThreatOutcome::win;
+				threatFilterResult.columns = getColumns(gameBoard, winningDropBits);
+				return threatFilterResult;
+			}
+
+			threatFilterResult.outcome = ThreatOutcome::open;
+			threatFilterResult.columns = getColumns(gameBoard, dropBits);
+			if (numberOfMovesAhead < 2) {
+				return threatFilterResult;
+			}
+
+			//Only one of two opponent wins can be blocked, so block the first and hope the opponent misses it
+			Bitboard opponentWinningBits = gameBoard.getWinningBits(isUserCoin ? false : true);
+			Bitboard candidateDropBits = dropBits;
+			Bitboard opponentWinningDropBits = opponentWinningBits & dropBits;
+			if (!opponentWinningDropBits.isEmpty()) {
+				if (opponentWinningDropBits.hasMoreThanOneBit()) {
+					threatFilterResult.outcome = ThreatOutcome::loss;
+					threatFilterResult.columns = getColumns(gameBoard, opponentWinningDropBits);
+					return threatFilterResult;
+				}
+				candidateDropBits = opponentWinningDropBits;
+			}
+
+			//A coin right below an opponent win lets the opponent win on top of it
+			Bitboard safeDropBits = candidateDropBits & ~(opponentWinningBits >> 1);
+			if (safeDropBits.isEmpty()) {
+				threatFilterResult.outcome = ThreatOutcome::loss;
+				threatFilterResult.columns = getColumns(gameBoard, candidateDropBits);
+				return threatFilterResult;
+			}
+			threatFilterResult.columns = getColumns(gameBoard, safeDropBits);
+
+			//None of the safe moves lets the opponent win right away, so a move that leaves two wins cannot be stopped
+			if (numberOfMovesAhead >= 3) {
+				GameBoardType threatGameBoard = gameBoard;
+				for (int columnCounter = 0; columnCounter < gameBoard.getNumberOfColumns(); ++columnCounter) {
+
+					if (!containsColumn(threatFilterResult.columns, columnCounter)) {
+						continue;
+					}
+
+					threatGameBoard.dropCoinUnchecked(columnCounter, isUserCoin);
+					bool isDoubleThreat = (threatGameBoard.getWinningBits(isUserCoin) & threatGameBoard.getDropBits()).hasMoreThanOneBit();
+					threatGameBoard.undoCoinUnchecked(columnCounter);
+
+					if (isDoubleThreat) {
+						threatFilterResult.outcome = ThreatOutcome::doubleThreat;
+						threatFilterResult.columns = std::uint32_t(1) << columnCounter;
+						return threatFilterResult;
+					}
+				}
+			}
+
+			return threatFilterResult;
+
+		}
+
+	};
+
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <tbb\combinable.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace controller {
+
+	//Kind of score stored for a position. Searches that cut off early only know a bound on the score.
+	enum class ScoreBound : std::uint8_t { none, exact, lowerBound, upperBound };
+
+	//Search result read back from the transposition table
+	struct TranspositionTableEntry {
+		int depth;
+		int score;
+		ScoreBound scoreBound;
+		int bestMove;
+	};
+
+	//Counters kept by the transposition table
+	struct TranspositionTableStatistics {
+		std::uint64_t probes;
+		std::uint64_t hits;
+		std::uint64_t collisions;
+		std::uint64_t stores;
+		std::uint64_t overwrites;
+	};
+
+	//Fixed size table of search results shared by all the TBB workers without any locks. Every slot keeps the packed
+	//entry and the position key XOR the packed entry in two atomic words. If two threads write the same slot at the
+	//same time the words no longer match and the next probe sees a different key instead of a wrong score.
+	class TranspositionTable {
+
+	private:
+
+		struct Slot {
+			std::atomic<std::uint64_t> keyXorData;
+			std::atomic<std::uint64_t> data;
+		};
+
+		//Constants
+		const static std::size_t BYTES_IN_MEGABYTE = 1024 * 1024;
+		const static std::uint64_t NO_BEST_MOVE = 0xFF;
+		const static std::uint64_t USER_TO_MOVE_KEY = 0xF1EA5EEDC0FFEE11ULL;
+		const static int DEPTH_SHIFT = 32;
+		const static int BOUND_SHIFT = 48;
+		const static int BEST_MOVE_SHIFT = 56;
+
+		//Members
+		std::unique_ptr<Slot[]> slots;
+		std::size_t numberOfSlots;
+		tbb::combinable<TranspositionTableStatistics> threadStatistics;
+		std::atomic<std::uint64_t> statisticsId;
+
+		//Pack an entry into one word. The bound is never none for a stored entry so a packed entry is never zero and
+		//zero can mark an empty slot. The depth takes 16 bits, far more than the 400 moves of the largest board.
+		static std::uint64_t packEntry(int depth, int score, ScoreBound scoreBound, int bestMove) {
+
+			assert(depth >= 0 && depth <= MAXIMUM_DEPTH);
+			std::uint64_t packedBestMove = bestMove < 0 ? NO_BEST_MOVE : static_cast<std::uint64_t>(bestMove);
+			return static_cast<std::uint64_t>(static_cast<std::uint32_t>(score)) |
+				(static_cast<std::uint64_t>(depth) << DEPTH_SHIFT) |
+				(static_cast<std::uint64_t>(scoreBound) << BOUND_SHIFT) |
+				(packedBestMove << BEST_MOVE_SHIFT);
+
+		}
+
+		static TranspositionTableEntry unpackEntry(std::uint64_t data) {
+
+			TranspositionTableEntry entry;
+			entry.score = static_cast<int>(static_cast<std::uint32_t>(data));
+			entry.depth = static_cast<int>((data >> DEPTH_SHIFT) & MAXIMUM_DEPTH);
+			entry.scoreBound = static_cast<ScoreBound>((data >> BOUND_SHIFT) & 0x3);
+			std::uint64_t packedBestMove = (data >> BEST_MOVE_SHIFT) & 0xFF;
+			entry.bestMove = packedBestMove == NO_BEST_MOVE ? -1 : static_cast<int>(packedBestMove);
+			return entry;
+
+		}
+
+		static std::uint64_t getNextStatisticsId() {
+
+			static std::atomic<std::uint64_t> nextStatisticsId(1);
+			return nextStatisticsId.fetch_add(1);
+
+		}
+
+		static TranspositionTableStatistics getEmptyStatistics() {
+
+			TranspositionTableStatistics statistics = {};
+			return statistics;
+
+		}
+
+		//The counters of the calling thread. Every thread counts in a shard of its own, so the threads probing and storing
+		//never write to the same cache line. As in SearchStatsCounters, the thread keeps a pointer to its shard tagged with
+		//an id that changes whenever the shards are cleared, and with every table.
+		TranspositionTableStatistics& getThreadStatistics() {
+
+			static thread_local std::uint64_t threadStatisticsId = 0;
+			static thread_local TranspositionTableStatistics* threadStatistics = nullptr;
+
+			std::uint64_t statisticsId = this->statisticsId.load(std::memory_order_relaxed);
+			if (threadStatisticsId != statisticsId) {
+				threadStatistics = &this->threadStatistics.local();
+				threadStatisticsId = statisticsId;
+			}
+
+			return *threadStatistics;
+
+		}
+
+		Slot& getSlot(std::uint64_t key) const {
+
+			return this->slots[key & (this->numberOfSlots - 1)];
+
+		}
+
+	public:
+
+		//Deepest depth an entry can keep
+		const static int MAXIMUM_DEPTH = 0xFFFF;
+
+		//An empty table does not store anything until it is given a size
+		TranspositionTable() : threadStatistics(getEmptyStatistics), statisticsId(getNextStatisticsId()) {
+
+			this->numberOfSlots = 0;
+
+		}
+
+		explicit TranspositionTable(std::size_t sizeInMegabytes) : TranspositionTable() {
+
+			resize(sizeInMegabytes);
+
+		}
+
+		TranspositionTable(const TranspositionTable&) = delete;
+		TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+		//Combine the board hash with the player to move so that the same coins with a different player to move do not
+		//share an entry
+		static std::uint64_t getKey(std::uint64_t boardHash, bool isUserToMove) {
+
+			return isUserToMove ? boardHash ^ USER_TO_MOVE_KEY : boardHash;
+
+		}
+
+		//Use the largest power of two number of slots that fits in the size. A size of zero turns the table off.
+		void resize(std::size_t sizeInMegabytes) {
+
+			std::size_t numberOfSlots = 1;
+			while (numberOfSlots * 2 * sizeof(Slot) <= sizeInMegabytes * BYTES_IN_MEGABYTE) {
+				numberOfSlots *= 2;
+			}
+
+			if (sizeInMegabytes == 0) {
+				this->slots.reset();
+				this->numberOfSlots = 0;
+			}
+			else {
+				this->slots.reset(new Slot[numberOfSlots]);
+				this->numberOfSlots = numberOfSlots;
+				clear();
+			}
+
+		}
+
+		//Forget all stored positions. Must not be called while a search is using the table.
+		void clear() {
+
+			for (std::size_t slotCounter = 0; slotCounter < this->numberOfSlots; ++slotCounter) {
+				this->slots[slotCounter].keyXorData.store(0, std::memory_order_relaxed);
+				this->slots[slotCounter].data.store(0, std::memory_order_relaxed);
+			}
+
+		}
+
+		std::size_t getSizeInBytes() const {
+
+			return this->numberOfSlots * sizeof(Slot);
+
+		}
+
+		//Look up a position. Returns true and fills in the entry if the position was found.
+		bool probe(std::uint64_t key, TranspositionTableEntry& entry) {
+
+			if (this->numberOfSlots == 0) {
+				return false;
+			}
+
+			TranspositionTableStatistics& statistics = getThreadStatistics();
+			++statistics.probes;
+
+			Slot& slot = getSlot(key);
+			std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+			std::uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+
+			if (data == 0) {
+				return false;
+			}
+			else if ((keyXorData ^ data) != key) {
+				++statistics.collisions;
+				return false;
+			}
+
+			++statistics.hits;
+			entry = unpackEntry(data);
+			return true;
+
+		}
+
+		//Save the result of searching a position. The slot always takes the latest result.
+		void store(std::uint64_t key, int depth, int score, ScoreBound scoreBound, int bestMove) {
+
+			if (this->numberOfSlots == 0) {
+				return;
+			}
+
+			TranspositionTableStatistics& statistics = getThreadStatistics();
+			++statistics.stores;
+
+			Slot& slot = getSlot(key);
+			std::uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+			std::uint64_t oldKeyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+			if (oldData != 0 && (oldKeyXorData ^ oldData) != key) {
+				++statistics.overwrites;
+			}
+
+			std::uint64_t data = packEntry(depth, score, scoreBound, bestMove);
+			slot.data.store(data, std::memory_order_relaxed);
+			slot.keyXorData.store(key ^ data, std::memory_order_relaxed);
+
+		}
+
+		//Merge the counters of all the threads. Must not be called while a search is using the table.
+		TranspositionTableStatistics getStatistics() {
+
+			return this->threadStatistics.combine([](const TranspositionTableStatistics& left, const TranspositionTableStatistics& right) {
+				TranspositionTableStatistics statistics;
+				statistics.probes = left.probes + right.probes;
+				statistics.hits = left.hits + right.hits;
+				statistics.collisions = left.collisions + right.collisions;
+				statistics.stores = left.stores + right.stores;
+				statistics.overwrites = left.overwrites + right.overwrites;
+				return statistics;
+			});
+
+		}
+
+		//Must not be called while a search is using the table
+		void resetStatistics() {
+
+			this->threadStatistics.clear();
+			this->statisticsId.store(getNextStatisticsId());
+
+		}
+
+	};
+
+}
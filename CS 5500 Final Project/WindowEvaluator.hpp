@@ -0,0 +1,186 @@
+#pragma once
+
+#include "GameBoard.hpp"
+#include "HeuristicScorer.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace controller {
+
+	//Keeps the number of user and computer coins in every window of a board, as long as the winning line. Dropping a coin
+	//or taking it back only updates the windows through its slot, so a move is scored from the counts of those windows
+	//instead of scanning the board. The window score of the whole board, computer windows less user windows, is kept as a
+	//running total in the same way. The windows through a slot come from the window table of the board, so nothing here
+	//checks the board edges or throws. The counts are sized to the windows of the board type, so the evaluator of a fixed
+	//size board is smaller and cheaper to copy for each parallel task.
+	template <typename GameBoardType>
+	class BasicWindowEvaluator {
+
+	private:
+
+		//Constants
+		const static int NUMBER_OF_WINDOWS = GameBoardType::MAXIMUM_NUMBER_OF_WINDOWS;
+
+		//Members
+		const HeuristicScorer* heuristicScorer;
+		std::uint8_t userCoinCounts[NUMBER_OF_WINDOWS];
+		std::uint8_t computerCoinCounts[NUMBER_OF_WINDOWS];
+		int runningScore;
+		int userWinningWindows, computerWinningWindows;
+		int winLength;
+
+		//Return the number of coins in a row that wins, which is a constant for boards of fixed size
+		int getWinLength() const {
+
+			return GameBoardType::HAS_FIXED_SIZE ? GameBoardType::DEFAULT_WIN_LENGTH : this->winLength;
+		}
+
+		//Score for a window holding the given number of coins of a player and none of the opponent
+		int getPlayerWindowScore(int coinCount) const {
+
+			if constexpr (GameBoardType::HAS_FIXED_SIZE) {
+				return this->heuristicScorer->getWindowScore(coinCount);
+			}
+			else {
+				return this->heuristicScorer->getWindowScore(coinCount, this->winLength);
+			}
+		}
+
+		//Call the function with the number of every window through the slot
+		template <typename WindowFunction>
+		void forEachWindowThrough(const GameBoardType& gameBoard, int boardIndex, WindowFunction windowFunction) const {
+
+			const typename GameBoardType::WindowTableType& windowTable = gameBoard.getWindowTable();
+			const std::uint16_t* windowsEnd = windowTable.getWindowsThroughSlotEnd(boardIndex);
+			for (const std::uint16_t* window = windowTable.getWindowsThroughSlotBegin(boardIndex); window != windowsEnd; ++window) {
+				windowFunction(*window);
+			}
+		}
+
+		//Score of a window from the computer point of view. Only a window holding the coins of one player scores, and a
+		//full window is counted separately as a win.
+		int getWindowScore(int userCoinCount, int computerCoinCount) const {
+
+			if (userCoinCount == 0 && computerCoinCount < getWinLength()) {
+				return getPlayerWindowScore(computerCoinCount);
+			}
+			else if (computerCoinCount == 0 && userCoinCount < getWinLength()) {
+				return -1 * getPlayerWindowScore(userCoinCount);
+			}
+			else {
+				return 0;
+			}
+		}
+
+		//Count a coin in every window through its slot
+		void addCoin(const GameBoardType& gameBoard, int boardIndex, bool isUserCoin) {
+
+			forEachWindowThrough(gameBoard, boardIndex, [this, isUserCoin](int windowNumber) {
+
+				int scoreBefore = getWindowScore(this->userCoinCounts[windowNumber], this->computerCoinCounts[windowNumber]);
+				std::uint8_t& coinCount = isUserCoin ? this->userCoinCounts[windowNumber] : this->computerCoinCounts[windowNumber];
+				if (++coinCount == getWinLength()) {
+					++(isUserCoin ? this->userWinningWindows : this->computerWinningWindows);
+				}
+				this->runningScore += getWindowScore(this->userCoinCounts[windowNumber], this->computerCoinCounts[windowNumber]) - scoreBefore;
+			});
+		}
+
+		//Take a coin out of every window through its slot
+		void removeCoin(const GameBoardType& gameBoard, int boardIndex, bool isUserCoin) {
+
+			forEachWindowThrough(gameBoard, boardIndex, [this, isUserCoin](int windowNumber) {
+
+				int scoreBefore = getWindowScore(this->userCoinCounts[windowNumber], this->computerCoinCounts[windowNumber]);
+				std::uint8_t& coinCount = isUserCoin ? this->userCoinCounts[windowNumber] : this->computerCoinCounts[windowNumber];
+				if (coinCount-- == getWinLength()) {
+					--(isUserCoin ? this->userWinningWindows : this->computerWinningWindows);
+				}
+				this->runningScore += getWindowScore(this->userCoinCounts[windowNumber], this->computerCoinCounts[windowNumber]) - scoreBefore;
+			});
+		}
+
+	public:
+
+		//Count the coins already on the board
+		BasicWindowEvaluator(const GameBoardType& gameBoard, const HeuristicScorer& heuristicScorer) {
+
+			this->heuristicScorer = &heuristicScorer;
+			std::memset(this->userCoinCounts, 0, sizeof(this->userCoinCounts));
+			std::memset(this->computerCoinCounts, 0, sizeof(this->computerCoinCounts));
+			this->runningScore = 0;
+			this->userWinningWindows = 0;
+			this->computerWinningWindows = 0;
+			this->winLength = gameBoard.getWinLength();
+
+			for (int boardIndex = 0; boardIndex < gameBoard.getNumberOfRows() * gameBoard.getNumberOfColumns(); ++boardIndex) {
+				if (!gameBoard.isEmptyAt(boardIndex)) {
+					addCoin(gameBoard, boardIndex, gameBoard.getGameSlot(boardIndex).hasUserCoin());
+				}
+			}
+		}
+
+		//Drop a coin into the column of the board and count it in its windows. The column must have room for the coin.
+		void dropCoin(GameBoardType& gameBoard, int columnNumber, bool isUserCoin) {
+
+			int boardIndex = gameBoard.getAvailableSlot(columnNumber);
+			gameBoard.dropCoinUnchecked(columnNumber, isUserCoin);
+			addCoin(gameBoard, boardIndex, isUserCoin);
+		}
+
+		//Take the top coin back out of the column of the board and out of its windows. The column must have a coin in it.
+		void undoCoin(GameBoardType& gameBoard, int columnNumber) {
+
+			bool isUserCoin = gameBoard.isUserCoinOnTop(columnNumber);
+			gameBoard.undoCoinUnchecked(columnNumber);
+			removeCoin(gameBoard, gameBoard.getAvailableSlot(columnNumber), isUserCoin);
+		}
+
+		//Heuristic score for dropping a coin into the column, or the winning score if the drop completes a winning line.
+		//Only the windows through the slot the coin lands in are looked at. The column must have room for the coin.
+		int getMoveHueristicScore(const GameBoardType& gameBoard, int columnPlayed, bool isUserCoin) const {
+
+			int moveScore = 0;
+			bool isWinningMove = false;
+
+			forEachWindowThrough(gameBoard, gameBoard.getAvailableSlot(columnPlayed), [&](int windowNumber) {
+
+				int playerCoinCount = isUserCoin ? this->userCoinCounts[windowNumber] : this->computerCoinCounts[windowNumber];
+				int opponentCoinCount = isUserCoin ? this->computerCoinCounts[windowNumber] : this->userCoinCounts[windowNumber];
+
+				//The coin about to be dropped is always part of the window
+				if (opponentCoinCount == 0) {
+					if (playerCoinCount + 1 == getWinLength()) {
+						isWinningMove = true;
+					}
+					else {
+						moveScore += getPlayerWindowScore(playerCoinCount + 1);
+					}
+				}
+			});
+
+			return isWinningMove ? HeuristicScorer::WINNING_SCORE : moveScore;
+		}
+
+		//Window score of the board from the point of view of the player, or the winning or losing score if either player
+		//has a winning line
+		int getScore(bool isUserCoin) const {
+
+			if (this->userWinningWindows > 0) {
+				return isUserCoin ? HeuristicScorer::WINNING_SCORE : -1 * HeuristicScorer::WINNING_SCORE;
+			}
+			else if (this->computerWinningWindows > 0) {
+				return isUserCoin ? -1 * HeuristicScorer::WINNING_SCORE : HeuristicScorer::WINNING_SCORE;
+			}
+			else {
+				return isUserCoin ? -1 * this->runningScore : this->runningScore;
+			}
+		}
+
+	};
+
+	//Evaluator for boards sized at run time
+	typedef BasicWindowEvaluator<model::GameBoard> WindowEvaluator;
+
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace model {
+
+	//Lays out every window of a board, the lines of slots as long as the number of coins in a row that wins, and for
+	//each slot the windows that contain it. The same steps fill the tables of fixed size boards at compile time and the
+	//tables of boards sized at run time.
+	class WindowTableLayout {
+
+	public:
+
+		//Number of slots in a window of Connect Four
+		const static int DEFAULT_WINDOW_LENGTH = 4;
+
+		//Number of directions a window can go in. A slot starts at most one window in each direction.
+		const static int NUMBER_OF_DIRECTIONS = 4;
+
+		//Count the windows that fit on a board. The directions are horizontal, vertical, diagonal going down and diagonal
+		//going up, all going right.
+		static constexpr int getNumberOfWindows(int numberOfRows, int numberOfColumns, int windowLength) {
+
+			int numberOfWindows = 0;
+			for (int direction = 0; direction < NUMBER_OF_DIRECTIONS; ++direction) {
+				for (int startRow = 0; startRow < numberOfRows; ++startRow) {
+					for (int startColumn = 0; startColumn < numberOfColumns; ++startColumn) {
+						if (isWindowOnBoard(numberOfRows, numberOfColumns, windowLength, direction, startRow, startColumn)) {
+							++numberOfWindows;
+						}
+					}
+				}
+			}
+
+			return numberOfWindows;
+
+		}
+
+		//Fill in the slots of each window, then the windows through each slot in window order. The windows of a slot end
+		//where the windows of the next slot begin, so there is one more offset than there are slots. Slots are board
+		//indexes counted row by row from the top left slot.
+		template <typename SlotList, typename OffsetList>
+		static constexpr void layOutWindows(int numberOfRows, int numberOfColumns, int windowLength, SlotList& windowSlots, OffsetList& slotWindowOffsets, SlotList& slotWindows) {
+
+			int numberOfWindows = 0;
+			for (int direction = 0; direction < NUMBER_OF_DIRECTIONS; ++direction) {
+				for (int startRow = 0; startRow < numberOfRows; ++startRow) {
+					for (int startColumn = 0; startColumn < numberOfColumns; ++startColumn) {
+
+						if (!isWindowOnBoard(numberOfRows, numberOfColumns, windowLength, direction, startRow, startColumn)) {
+							continue;
+						}
+
+						for (int step = 0; step < windowLength; ++step) {
+							int boardIndex = (startRow + step * getRowStep(direction)) * numberOfColumns + startColumn + step * getColumnStep(direction);
+							windowSlots[numberOfWindows * windowLength + step] = static_cast<std::uint16_t>(boardIndex);
+						}
+						++numberOfWindows;
+					}
+				}
+			}
+
+			int numberOfSlotWindows = 0;
+			for (int boardIndex = 0; boardIndex < numberOfRows * numberOfColumns; ++boardIndex) {
+				slotWindowOffsets[boardIndex] = static_cast<std::uint16_t>(numberOfSlotWindows);
+				for (int windowNumber = 0; windowNumber < numberOfWindows; ++windowNumber) {
+					for (int step = 0; step < windowLength; ++step) {
+						if (windowSlots[windowNumber * windowLength + step] == boardIndex) {
+							slotWindows[numberOfSlotWindows++] = static_cast<std::uint16_t>(windowNumber);
+						}
+					}
+				}
+			}
+			slotWindowOffsets[numberOfRows * numberOfColumns] = static_cast<std::uint16_t>(numberOfSlotWindows);
+
+		}
+
+	private:
+
+		static constexpr int getRowStep(int direction) {
+
+			return direction == 0 ? 0 : (direction == 3 ? -1 : 1);
+
+		}
+
+		static constexpr int getColumnStep(int direction) {
+
+			return direction == 1 ? 0 : 1;
+
+		}
+
+		static constexpr bool isWindowOnBoard(int numberOfRows, int numberOfColumns, int windowLength, int direction, int startRow, int startColumn) {
+
+			int endRow = startRow + (windowLength - 1) * getRowStep(direction);
+			int endColumn = startColumn + (windowLength - 1) * getColumnStep(direction);
+			return endRow >= 0 && endRow < numberOfRows && endColumn < numberOfColumns;
+
+		}
+
+	};
+
+	//Window table of a board whose dimensions are fixed at compile time, which is always played to four in a row. The
+	//table is built by the compiler and sized to the exact number of windows, so the board geometry ends up as constants
+	//in the evaluation.
+	template <int FIXED_NUMBER_OF_ROWS = 0, int FIXED_NUMBER_OF_COLUMNS = 0>
+	class BasicWindowTable {
+
+	public:
+
+		//Number of slots in a window
+		const static int WINDOW_LENGTH = WindowTableLayout::DEFAULT_WINDOW_LENGTH;
+
+		//Number of windows on the board, which is also the most a table of this type can hold
+		const static int MAXIMUM_NUMBER_OF_WINDOWS = WindowTableLayout::getNumberOfWindows(FIXED_NUMBER_OF_ROWS, FIXED_NUMBER_OF_COLUMNS, WINDOW_LENGTH);
+
+	private:
+
+		//Constants
+		const static int NUMBER_OF_SLOTS = FIXED_NUMBER_OF_ROWS * FIXED_NUMBER_OF_COLUMNS;
+
+		//Members
+		std::array<std::uint16_t, MAXIMUM_NUMBER_OF_WINDOWS * WINDOW_LENGTH> windowSlots;
+		std::array<std::uint16_t, NUMBER_OF_SLOTS + 1> slotWindowOffsets;
+		std::array<std::uint16_t, MAXIMUM_NUMBER_OF_WINDOWS * WINDOW_LENGTH> slotWindows;
+
+		constexpr BasicWindowTable() : windowSlots(), slotWindowOffsets(), slotWindows() {
+
+			WindowTableLayout::layOutWindows(FIXED_NUMBER_OF_ROWS, FIXED_NUMBER_OF_COLUMNS, WINDOW_LENGTH, this->windowSlots, this->slotWindowOffsets, this->slotWindows);
+
+		}
+
+	public:
+
+		BasicWindowTable(const BasicWindowTable&) = delete;
+		BasicWindowTable& operator=(const BasicWindowTable&) = delete;
+
+		//Return the table, which is built at compile time
+		static const BasicWindowTable& getWindowTable() {
+
+			static constexpr BasicWindowTable windowTable{};
+			return windowTable;
+
+		}
+
+		constexpr int getNumberOfWindows() const {
+
+			return MAXIMUM_NUMBER_OF_WINDOWS;
+
+		}
+
+		constexpr int getWindowLength() const {
+
+			return WINDOW_LENGTH;
+
+		}
+
+		//Return the board indexes of the slots of a window
+		const std::uint16_t* getWindowSlots(int windowNumber) const {
+
+			return this->windowSlots.data() + windowNumber * WINDOW_LENGTH;
+
+		}
+
+		//Return the first of the windows through a slot. They end where the windows of the next slot begin.
+		const std::uint16_t* getWindowsThroughSlotBegin(int boardIndex) const {
+
+			return this->slotWindows.data() + this->slotWindowOffsets[boardIndex];
+
+		}
+
+		const std::uint16_t* getWindowsThroughSlotEnd(int boardIndex) const {
+
+			return this->slotWindows.data() + this->slotWindowOffsets[boardIndex + 1];
+
+		}
+
+	};
+
+	//Window table of a board whose dimensions and win length are set at run time. Tables are built once per board size
+	//and win length and shared by every board like it, so the evaluation can walk windows through a slot by looking them
+	//up instead of stepping across the board and checking the edges.
+	template <>
+	class BasicWindowTable<0, 0> {
+
+	private:
+
+		//Members
+		std::vector<std::uint16_t> windowSlots;
+		std::vector<std::uint16_t> slotWindowOffsets;
+		std::vector<std::uint16_t> slotWindows;
+		int windowLength;
+
+		BasicWindowTable(int numberOfRows, int numberOfColumns, int windowLength) {
+
+			int numberOfWindows = WindowTableLayout::getNumberOfWindows(numberOfRows, numberOfColumns, windowLength);
+			this->windowSlots.resize(numberOfWindows * windowLength);
+			this->slotWindowOffsets.resize(numberOfRows * numberOfColumns + 1);
+			this->slotWindows.resize(numberOfWindows * windowLength);
+			this->windowLength = windowLength;
+			WindowTableLayout::layOutWindows(numberOfRows, numberOfColumns, windowLength, this->windowSlots, this->slotWindowOffsets, this->slotWindows);
+
+		}
+
+	public:
+
+		BasicWindowTable(const BasicWindowTable&) = delete;
+		BasicWindowTable& operator=(const BasicWindowTable&) = delete;
+
+		//Return the table for boards of the given size and win length, building it the first time it is asked for
+		static const BasicWindowTable& getWindowTable(int numberOfRows, int numberOfColumns, int windowLength) {
+
+			static std::mutex windowTablesMutex;
+			static std::map<std::tuple<int, int, int>, std::unique_ptr<BasicWindowTable>> windowTables;
+
+			std::lock_guard<std::mutex> lock(windowTablesMutex);
+			std::unique_ptr<BasicWindowTable>& windowTable = windowTables[std::make_tuple(numberOfRows, numberOfColumns, windowLength)];
+			if (!windowTable) {
+				windowTable.reset(new BasicWindowTable(numberOfRows, numberOfColumns, windowLength));
+			}
+
+			return *windowTable;
+
+		}
+
+		int getNumberOfWindows() const {
+
+			return static_cast<int>(this->windowSlots.size() / this->windowLength);
+
+		}
+
+		int getWindowLength() const {
+
+			return this->windowLength;
+
+		}
+
+		//Return the board indexes of the slots of a window
+		const std::uint16_t* getWindowSlots(int windowNumber) const {
+
+			return this->windowSlots.data() + windowNumber * this->windowLength;
+
+		}
+
+		//Return the first of the windows through a slot. They end where the windows of the next slot begin.
+		const std::uint16_t* getWindowsThroughSlotBegin(int boardIndex) const {
+
+			return this->slotWindows.data() + this->slotWindowOffsets[boardIndex];
+
+		}
+
+		const std::uint16_t* getWindowsThroughSlotEnd(int boardIndex) const {
+
+			return this->slotWindows.data() + this->slotWindowOffsets[boardIndex + 1];
+
+		}
+
+	};
+
+	//Window table of boards sized at run time
+	typedef BasicWindowTable<> WindowTable;
+
+}